@@ -0,0 +1,107 @@
+/*!
+ * A tiny micro-benchmark harness: warm-up, adaptive iteration count,
+ * do-not-optimize barrier and summary statistics over repeated samples.
+ * @date July, 31st.
+ * @author Selan
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>    // std::sort
+#include <chrono>       // std::chrono::steady_clock
+#include <cmath>        // std::sqrt
+#include <cstddef>      // std::size_t
+#include <numeric>      // std::accumulate
+#include <vector>       // std::vector
+
+/// Benchmarking namespace.
+namespace bench {
+
+    /// Forces the compiler to assume `value` is read, so the code that produced it is kept.
+    template < typename T >
+    inline void do_not_optimize( const T & value )
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const T * sink;
+        sink = &value;
+#endif
+    }
+
+    /// How a single measurement is carried out.
+    struct Options {
+        int warmup_samples{ 3 };       //!< Samples run and discarded before measuring.
+        int samples{ 30 };             //!< Samples kept for the statistics.
+        double min_sample_ns{ 2e5 };   //!< Iterations per sample grow until one sample takes at least this long.
+        std::size_t max_iterations{ std::size_t{1} << 24 }; //!< Upper limit for the iterations per sample.
+    };
+
+    /// Summary of the samples of one measurement, in nanoseconds per iteration.
+    struct Stats {
+        std::size_t iterations{ 0 };   //!< Iterations per sample.
+        int samples{ 0 };              //!< Number of samples.
+        double min{ 0 };               //!< Fastest sample.
+        double median{ 0 };            //!< Median sample.
+        double p95{ 0 };               //!< 95th percentile.
+        double mean{ 0 };              //!< Arithmetic mean.
+        double stddev{ 0 };            //!< Sample standard deviation.
+    };
+
+    /// Computes the summary statistics of `values` (which gets sorted).
+    inline Stats summarize( std::vector< double > & values, std::size_t iterations )
+    {
+        Stats s;
+        s.iterations = iterations;
+        s.samples = static_cast<int>(values.size());
+        if(values.empty()) return s;
+        std::sort(values.begin(), values.end());
+        auto n = values.size();
+        // nearest-rank percentile.
+        auto percentile = [&]( double p ){ return values[ std::min(n - 1, static_cast<std::size_t>(p * n)) ]; };
+        s.min = values.front();
+        s.median = n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+        s.p95 = percentile(0.95);
+        s.mean = std::accumulate(values.begin(), values.end(), 0.0) / n;
+        double sq = 0;
+        for(auto v : values) sq += (v - s.mean) * (v - s.mean);
+        s.stddev = n > 1 ? std::sqrt(sq / (n - 1)) : 0;
+        return s;
+    }
+
+    /// Runs `fn(i)` for i in [0;iterations) and returns the elapsed time in nanoseconds.
+    template < typename Fn >
+    double run_sample( Fn & fn, std::size_t iterations )
+    {
+        auto start = std::chrono::steady_clock::now();
+        for(std::size_t i = 0; i < iterations; i++) fn(i);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration< double, std::nano >(end - start).count();
+    }
+
+    /*!
+     * Measures `fn`, a callable that takes the iteration index.
+     *
+     * The iterations per sample double until a sample lasts at least
+     * `opt.min_sample_ns`, so that clock resolution does not dominate. Then
+     * `opt.warmup_samples` samples are thrown away and `opt.samples` are kept.
+     * @return the statistics of the time per iteration.
+     */
+    template < typename Fn >
+    Stats measure( Fn fn, const Options & opt = Options{} )
+    {
+        std::size_t iterations = 1;
+        while(iterations < opt.max_iterations && run_sample(fn, iterations) < opt.min_sample_ns)
+            iterations *= 2;
+        for(int i = 0; i < opt.warmup_samples; i++) run_sample(fn, iterations);
+
+        std::vector< double > values;
+        values.reserve(opt.samples);
+        for(int i = 0; i < opt.samples; i++)
+            values.push_back(run_sample(fn, iterations) / iterations);
+        return summarize(values, iterations);
+    }
+}
+
+#endif // BENCH_H
@@ -0,0 +1,204 @@
+/*!
+ * Benchmark driver for the searching algorithms.
+ *
+ * For every range size (a geometric sweep) and every hit ratio (the fraction of
+ * queries whose target is present), each algorithm answers a fixed pool of
+ * random queries. Each measurement is warmed up, its iteration count adapts to
+ * the cost of the algorithm, and the results go through a do-not-optimize
+ * barrier; the output reports min/median/p95/mean/stddev in nanoseconds per query.
+ *
+ * Usage: benchmark [options]
+ *   --min N          smallest range size (default 1000)
+ *   --max N          largest range size (default 10000000)
+ *   --step F         geometric step between sizes (default 10)
+ *   --hit R1,R2,...  hit ratios in [0,1] (default 0,0.5,1)
+ *   --algos A,B,...  algorithms to run (default: all of them)
+ *   --linear-max N   largest size for the sequential O(n) algorithms (default 100000);
+ *                    plsearch only splits ranges past 2 * min_chunk, so it runs on all sizes
+ *   --samples N      samples per measurement, > 0 (default 30)
+ *   --format F       csv or json (default csv)
+ *   --out FILE       output file (default: standard output)
+ *   --help           prints the usage message
+ * @date July, 31st.
+ * @author Selan
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include <stdexcept>
+#include "searching.h"
+#include "eytzinger.h"
+#include "bench.h"
+
+/// One line of the report.
+struct Record {
+    std::string algorithm;  //!< Algorithm name.
+    std::size_t size;       //!< Range size.
+    double hit_ratio;       //!< Fraction of the queries whose target is present.
+    bench::Stats stats;     //!< Time per query.
+};
+
+/// Command line options.
+struct RunningOpt {
+    std::size_t min_size{ 1000 };
+    std::size_t max_size{ 10000000 };
+    double step{ 10 };
+    std::vector< double > hit_ratios{ 0, 0.5, 1 };
+    std::vector< std::string > algos;   //!< Empty means all.
+    std::size_t linear_max{ 100000 };
+    std::string format{ "csv" };
+    std::string out;
+    bench::Options bench;
+};
+
+/// Number of queries in the pool cycled through by every measurement (a power of 2).
+constexpr std::size_t N_QUERIES = 4096;
+
+/// Splits a comma separated list.
+std::vector< std::string > split( const std::string & list )
+{
+    std::vector< std::string > items;
+    std::istringstream iss{ list };
+    std::string item;
+    while(std::getline(iss, item, ',')) if(!item.empty()) items.push_back(item);
+    return items;
+}
+
+/// Prints the usage message and exits with `status`.
+void usage( int status )
+{
+    (status == EXIT_SUCCESS ? std::cout : std::cerr)
+        << "Usage: benchmark [--min N] [--max N] [--step F] [--hit R1,R2,...] [--algos A,B,...]\n"
+        << "                 [--linear-max N] [--samples N] [--format csv|json] [--out FILE]\n";
+    std::exit(status);
+}
+
+/// Parses the command line, exiting with a message on invalid input.
+RunningOpt parse( int argc, char * argv[] )
+{
+    RunningOpt opt;
+    for(int i = 1; i < argc; i++) {
+        std::string arg{ argv[i] };
+        if(arg == "--help") usage(EXIT_SUCCESS);
+        if(i + 1 >= argc) { std::cerr << "Missing value for " << arg << "\n"; usage(EXIT_FAILURE); }
+        std::string value{ argv[++i] };
+        try {
+            if(arg == "--min") opt.min_size = std::stoull(value);
+            else if(arg == "--max") opt.max_size = std::stoull(value);
+            else if(arg == "--step") opt.step = std::stod(value);
+            else if(arg == "--linear-max") opt.linear_max = std::stoull(value);
+            else if(arg == "--samples") opt.bench.samples = std::stoi(value);
+            else if(arg == "--format") opt.format = value;
+            else if(arg == "--out") opt.out = value;
+            else if(arg == "--algos") opt.algos = split(value);
+            else if(arg == "--hit") {
+                opt.hit_ratios.clear();
+                for(const auto & r : split(value)) opt.hit_ratios.push_back(std::stod(r));
+            }
+            else { std::cerr << "Unknown option " << arg << "\n"; usage(EXIT_FAILURE); }
+        }
+        catch(const std::exception &) {
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            usage(EXIT_FAILURE);
+        }
+    }
+    bool hits_valid = std::all_of(opt.hit_ratios.begin(), opt.hit_ratios.end(),
+                                  []( double r ){ return r >= 0 && r <= 1; });
+    if(opt.step <= 1 || opt.min_size == 0 || opt.bench.samples <= 0 || !hits_valid
+       || (opt.format != "csv" && opt.format != "json")) {
+        std::cerr << "Invalid options: --step must be > 1, --min > 0, --samples > 0, --hit ratios in [0,1]"
+                  << " and --format csv or json.\n";
+        usage(EXIT_FAILURE);
+    }
+    return opt;
+}
+
+/// Writes the report as CSV.
+void write_csv( std::ostream & os, const std::vector< Record > & records )
+{
+    os << "algorithm,size,hit_ratio,iterations,samples,min_ns,median_ns,p95_ns,mean_ns,stddev_ns\n";
+    for(const auto & r : records)
+        os << r.algorithm << "," << r.size << "," << r.hit_ratio << "," << r.stats.iterations << ","
+           << r.stats.samples << "," << r.stats.min << "," << r.stats.median << "," << r.stats.p95 << ","
+           << r.stats.mean << "," << r.stats.stddev << "\n";
+}
+
+/// Writes the report as a JSON array of objects.
+void write_json( std::ostream & os, const std::vector< Record > & records )
+{
+    os << "[\n";
+    for(std::size_t i = 0; i < records.size(); i++) {
+        const auto & r = records[i];
+        os << "  { \"algorithm\": \"" << r.algorithm << "\", \"size\": " << r.size
+           << ", \"hit_ratio\": " << r.hit_ratio << ", \"iterations\": " << r.stats.iterations
+           << ", \"samples\": " << r.stats.samples << ", \"min_ns\": " << r.stats.min
+           << ", \"median_ns\": " << r.stats.median << ", \"p95_ns\": " << r.stats.p95
+           << ", \"mean_ns\": " << r.stats.mean << ", \"stddev_ns\": " << r.stats.stddev << " }"
+           << (i + 1 < records.size() ? ",\n" : "\n");
+    }
+    os << "]\n";
+}
+
+int main( int argc, char * argv[] )
+{
+    RunningOpt opt = parse(argc, argv);
+    std::vector< Record > records;
+    std::mt19937 gen{ 2021 };
+
+    for(double dsize = static_cast<double>(opt.min_size); dsize <= opt.max_size; dsize *= opt.step) {
+        auto size = static_cast<std::size_t>(dsize);
+        // even numbers only, so odd targets are guaranteed misses.
+        std::vector< int > v(size);
+        for(std::size_t i = 0; i < size; i++) v[i] = static_cast<int>(2 * i);
+        const int * first = v.data();
+        const int * last = v.data() + v.size();
+        sa::eytzinger_index< int > index(v.begin(), v.end());
+
+        for(double hit_ratio : opt.hit_ratios) {
+            std::uniform_int_distribution< std::size_t > pos(0, size - 1);
+            std::bernoulli_distribution hit(hit_ratio);
+            std::vector< int > keys(N_QUERIES);
+            for(auto & key : keys) key = v[pos(gen)] + (hit(gen) ? 0 : 1);
+
+            // measures one algorithm, unless it was left out or is linear and the range is too big.
+            auto run = [&]( const char * name, bool linear, auto search ) {
+                bool wanted = opt.algos.empty()
+                    || std::find(opt.algos.begin(), opt.algos.end(), name) != opt.algos.end();
+                if(!wanted || (linear && size > opt.linear_max)) return;
+                std::cerr << ">>> " << name << " size=" << size << " hit=" << hit_ratio << "\n";
+                auto stats = bench::measure([&]( std::size_t i ) {
+                    bench::do_not_optimize(search(keys[i & (N_QUERIES - 1)]));
+                }, opt.bench);
+                records.push_back({ name, size, hit_ratio, stats });
+            };
+
+            run("lsearch", true, [&]( int key ){ return sa::lsearch(first, last, key); });
+            // not capped by --linear-max: below 2 * min_chunk it would only time its serial fallback.
+            run("plsearch", false, [&]( int key ){ return sa::plsearch(first, last, key); });
+            run("lbound_linear", true, [&]( int key ){ return sa::lbound_linear(first, last, key); });
+            run("bsearch", false, [&]( int key ){ return sa::bsearch(first, last, key); });
+            run("bsearchr", false, [&]( int key ){ return sa::bsearchr(first, last, key); });
+            run("lbound", false, [&]( int key ){ return sa::lbound(first, last, key); });
+            run("ubound", false, [&]( int key ){ return sa::ubound(first, last, key); });
+            run("lbound+ubound", false, [&]( int key ){
+                return sa::ubound(first, last, key) - sa::lbound(first, last, key); });
+            run("count_sorted", false, [&]( int key ){ return sa::count_sorted(first, last, key); });
+            run("isearch", false, [&]( int key ){ return sa::isearch(first, last, key); });
+            run("esearch", false, [&]( int key ){ return sa::esearch(first, last, key); });
+            run("eytzinger", false, [&]( int key ){ return index.find(key); });
+        }
+    }
+
+    std::ofstream file;
+    if(!opt.out.empty()) file.open(opt.out);
+    std::ostream & os = opt.out.empty() ? std::cout : file;
+    if(opt.format == "json") write_json(os, records);
+    else write_csv(os, records);
+    return EXIT_SUCCESS;
+}
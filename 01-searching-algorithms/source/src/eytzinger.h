@@ -0,0 +1,164 @@
+/*!
+ * A search index that stores a sorted range in Eytzinger (BFS) order.
+ *
+ * Element k of the layout has its children at 2k and 2k+1, so the first levels of
+ * the implicit tree share a handful of cache lines and, at every level, the 16
+ * (for 4-byte keys) possible grandchildren four levels down sit in one 64-byte
+ * line that can be prefetched before they are needed. Binary search over the
+ * plain array, on the other hand, takes a cache miss on almost every level once
+ * the range no longer fits in cache.
+ *
+ * \author Selan R. dos Santos
+ * \date July, 31st.
+ */
+
+#ifndef EYTZINGER_H
+#define EYTZINGER_H
+
+#include <cstddef>      // std::size_t
+#include <functional>   // std::less
+#include <iterator>     // std::distance
+#include <vector>       // std::vector
+
+#include "searching.h"  // SA_PREFETCH
+
+/// Searching Algorithms Namespace
+namespace sa {
+
+    /// Prebuilt Eytzinger layout of a sorted range.
+    template < typename T, typename Compare = std::less<> >
+    class eytzinger_index {
+        public:
+            using size_type = std::size_t;
+
+            /*!
+             * Builds the index from a copy of the sorted range [first;last).
+             * @note The range **must** be sorted with respect to `cmp`.
+             * @param first Iterator to the begining of the data range.
+             * @param last Iterator just past the last element of the data range.
+             * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+             */
+            template < typename RandomIt >
+            eytzinger_index( RandomIt first, RandomIt last, Compare cmp = Compare{} )
+                : m_keys( std::distance(first, last) + 1 ),
+                  m_height{ size() == 0 ? 0 : floor_log2(size()) + 1 },
+                  m_cmp{ cmp }
+            {
+                size_type i = 0;
+                build(first, i, 1);
+            }
+
+            /// Number of elements indexed.
+            size_type size( void ) const { return m_keys.size() - 1; }
+
+            /*!
+             * Returns the position, in the original range, of the first element that
+             * is not less than `value`, or size() if there is no such element.
+             */
+            size_type lower_bound( const T & value ) const
+            {
+                return position( descend(value, [this]( const T & key, const T & v ){ return m_cmp(key, v); }) );
+            }
+
+            /*!
+             * Returns the position, in the original range, of the first element that
+             * is greater than `value`, or size() if there is no such element.
+             */
+            size_type upper_bound( const T & value ) const
+            {
+                return position( descend(value, [this]( const T & key, const T & v ){ return !m_cmp(v, key); }) );
+            }
+
+            /*!
+             * Returns the position, in the original range, of an element equivalent
+             * to `value`, or size() if there is no such element.
+             */
+            size_type find( const T & value ) const
+            {
+                size_type k = descend(value, [this]( const T & key, const T & v ){ return m_cmp(key, v); });
+                return (k != 0 && !m_cmp(value, m_keys[k])) ? rank(k) : size();
+            }
+
+        private:
+            /// Keys per 64-byte cache line; also how far ahead (in tree index) we prefetch.
+            static constexpr size_type BLOCK = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+            std::vector< T > m_keys;  //!< The keys in BFS order; slot 0 is unused.
+            int m_height;             //!< Number of levels of the implicit tree.
+            Compare m_cmp;            //!< The order the range was sorted by.
+
+            /// In-order traversal of the implicit tree, filling node k and its subtrees.
+            template < typename RandomIt >
+            void build( RandomIt first, size_type & i, size_type k )
+            {
+                if(k >= m_keys.size()) return;
+                build(first, i, 2 * k);
+                m_keys[k] = first[i++];
+                build(first, i, 2 * k + 1);
+            }
+
+            /*!
+             * Walks down the tree going right while `go_right(key, value)` holds, then
+             * undoes the trailing right turns plus one left turn: the node we end up
+             * at is the answer, or 0 if every key went right.
+             */
+            template < typename GoRight >
+            size_type descend( const T & value, GoRight go_right ) const
+            {
+                const size_type n = size();
+                const T * keys = m_keys.data();
+                size_type k = 1;
+                while(k <= n) {
+                    SA_PREFETCH(keys + BLOCK * k);
+                    k = 2 * k + go_right(keys[k], value);
+                }
+                // drop the trailing 1-bits (right turns) and the 0-bit (left turn) before them.
+                return k >> (trailing_ones(k) + 1);
+            }
+
+            /// Number of consecutive 1-bits at the bottom of k.
+            static int trailing_ones( size_type k )
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                return __builtin_ctzll( ~static_cast<unsigned long long>(k) );
+#else
+                int n = 0;
+                while(k & 1) { k >>= 1; n++; }
+                return n;
+#endif
+            }
+
+            /// Depth of node k (k > 0), i.e. floor(log2(k)).
+            static int floor_log2( size_type k )
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                return 63 - __builtin_clzll( static_cast<unsigned long long>(k) );
+#else
+                int d = 0;
+                while(k >>= 1) d++;
+                return d;
+#endif
+            }
+
+            /*!
+             * In-order rank of node k, i.e. its position in the original range.
+             *
+             * Computed instead of stored, so that the answer costs no extra memory
+             * access: first the rank k would have if the last level were full, then
+             * minus the missing leaves (always the rightmost ones) that come before it.
+             */
+            size_type rank( size_type k ) const
+            {
+                const int d = floor_log2(k);
+                const size_type full = ((2 * (k - (size_type{1} << d)) + 1) << (m_height - 1 - d)) - 1;
+                const size_type leaves = size() - (size_type{1} << (m_height - 1)) + 1;
+                const size_type leaves_before = (full + 1) / 2;
+                return full - (leaves_before > leaves ? leaves_before - leaves : 0);
+            }
+
+            /// Maps a tree node back to the original range; node 0 means "past the end".
+            size_type position( size_type k ) const { return k == 0 ? size() : rank(k); }
+    };
+}
+
+#endif // EYTZINGER_H
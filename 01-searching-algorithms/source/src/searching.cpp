@@ -1,145 +1,121 @@
 /*!
  * \file searching.cpp
- * Binary search, Linear search, Upper bound, lower bound implementation for an array of integers.
+ * Vectorized linear search kernels for arrays of 32-bit integers.
+ *
+ * On x86 there is one SSE2 kernel (always available on x86-64) and one AVX2
+ * kernel; the one to use is picked at runtime, on the first call, based on what
+ * the CPU supports. Any other architecture gets the scalar loop.
  * \author Selan R. dos Santos
  * \date June 17th, 2021.
  */
 
 #include "searching.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#   define SA_X86_SIMD
+#   include <immintrin.h>
+#endif
+
 namespace sa {
+    namespace detail {
 
-    /*!
-     * Performs a linear search for target-value in [first;last) and returns a pointer
-       to the location of value in the range [first,last], or a pointer to last if no
-       such element is found.
-     * @param first Pointer to the begining of the data range.
-     * @param last Pointer just past the last element of the data range.
-     * @param value The value we are looking for.
-     * @return a pointer to the location of target-value in the range [first, last)
-     *     or a pointer to last if target is not found.
-     */
-    value_type * lsearch( value_type * first, value_type * last, value_type value )
-    {
-        while(first != last) {
-            if(*(first) == value) return first;
-                else first++;
-        }
-        // if the target is not within the range passed to the function
-        // immediately after the last while loop, at this time first points to last
-        return first;
-    }
+        namespace {
+            /// Signature shared by all kernels.
+            using lsearch_i32_fn = const std::int32_t * (*)( const std::int32_t *, const std::int32_t *, std::int32_t );
 
-    /*!
-     * Performs a binary search for target-value in [first;last) and returns a pointer
-        to the location of value in the range [first,last], or a pointer to last if no
-        such element is found.
-     * @note The range **must** be sorted.
-     * @param first Pointer to the begining of the data range.
-     * @param last Pointer just past the last element of the data range.
-     * @param value The value we are looking for.
-     * @return a pointer to the location of target-value in the range [first, last)
-     *     or a pointer to last if target is not found.
-     */
-    value_type * bsearch( value_type * first, value_type * last, value_type value )
-    {
-        int *saved_last = last;
-        while(first != last) {
-            // pointer to the middle
-            int * mid = first + (last - first)/2;
-            // the middle element is the target
-            if(*mid == value) return mid;
-            // middle element is greater than target, search in left subarray
-            else if (*mid > value) last = mid;
-            // middle element is less than target, search in right subarray
-            else first = ++mid;
-        }
-        // if the target is not within the range passed to the function
-        return saved_last;
-    }
+            /// Plain scalar loop, also used to finish the tail of the vector kernels.
+            const std::int32_t * lsearch_i32_scalar( const std::int32_t * first, const std::int32_t * last, std::int32_t value )
+            {
+                while(first != last) {
+                    if(*first == value) return first;
+                    else first++;
+                }
+                return first;
+            }
 
-    /*!
-     * A wrapper function that holds the position of last and calls the actual
-       recursive binary search (bsearchr).
-     * @note The range must be sorted.
-     * @param first Pointer to the begining of the data range.
-     * @param last Pointer just past the last element of the data range.
-     * @param value The value we are looking for.
-     * @return a pointer to the location of target-value in the range [first, last)
-     *     or a null pointer if target is not found.
-     */
-    value_type * bsearchrwrapper( value_type * first, value_type * last, value_type value ) {
-        int* pos = bsearchr(first, last, value);
-        if(pos == nullptr) return last;
-        else return pos;
-    }
+#ifdef SA_X86_SIMD
+            /// Lowest set bit of a non-zero mask.
+            inline int first_bit( unsigned mask ) { return __builtin_ctz(mask); }
 
-    /*!
-     * Performs a recursive binary search for target-value in [first;last) and returns a pointer
-       to the location of value in the range [first,last], or a pointer to last if no such
-       element is found.
-     * @note The range must be sorted.
-     * @param first Pointer to the begining of the data range.
-     * @param last Pointer just past the last element of the data range.
-     * @param value The value we are looking for.
-     * @return a pointer to the location of target-value in the range [first, last)
-     *     or a pointer to last if target is not found.
-     */
-    value_type * bsearchr( value_type * first, value_type * last, value_type value )
-    {
-        if(first != last) {
-            // pointer to the middle
-            int* mid = first + (last - first)/2;
-            // the middle element is the target
-            if(*mid == value) return mid;
-            // middle element is greater than target, search in left subarray
-            else if(*mid > value) return bsearchr(first, mid, value);
-            // middle element is less than target, search in right subarray
-            else return bsearchr(++mid, last, value);
-        // if the target is not within the range passed to the function
-        } else return nullptr;         
-    }
+            /// SSE2 kernel: 16 lanes (4 vectors of 4 ints) per iteration.
+            __attribute__((target("sse2")))
+            const std::int32_t * lsearch_i32_sse2( const std::int32_t * first, const std::int32_t * last, std::int32_t value )
+            {
+                const __m128i key = _mm_set1_epi32(value);
+                for( ; last - first >= 16; first += 16) {
+                    __m128i c0 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), key);
+                    __m128i c1 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 4)), key);
+                    __m128i c2 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 8)), key);
+                    __m128i c3 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 12)), key);
+                    __m128i any = _mm_or_si128(_mm_or_si128(c0, c1), _mm_or_si128(c2, c3));
+                    if(_mm_movemask_epi8(any) == 0) continue;
+                    // one movemask bit per lane; the first hit is the lowest bit set.
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(c0)))
+                                  | static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(c1))) << 4
+                                  | static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(c2))) << 8
+                                  | static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(c3))) << 12;
+                    return first + first_bit(mask);
+                }
+                return lsearch_i32_scalar(first, last, value);
+            }
 
-    /*!
-     * Returns a pointer to the first element in the range [first, last) that is not less 
-       than (i.e. greater or equal to) value, or a pointer to last if no such element is found.
-     * @note The range must be sorted.
-     * @param first Pointer to the begining of the data range.
-     * @param last Pointer just past the last element of the data range.
-     * @param value The value we are looking for.
-     * @return a pointer to the location of the first element that is not less than 'value'
-     *    in the range [first, last) or a pointer to last if there is no such element in
-     *    this range.
-     */
-    value_type * lbound( value_type * first, value_type * last, value_type value )
-    {
-        // linear search for the first element that is not less than the target
-        // search for the first element greater than or equal to the target
-        while(first != last) {
-            if(*first >= value) return first;
-            else first++;
+            /// AVX2 kernel: 32 lanes (4 vectors of 8 ints) per iteration.
+            __attribute__((target("avx2")))
+            const std::int32_t * lsearch_i32_avx2( const std::int32_t * first, const std::int32_t * last, std::int32_t value )
+            {
+                const __m256i key = _mm256_set1_epi32(value);
+                for( ; last - first >= 32; first += 32) {
+                    __m256i c0 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), key);
+                    __m256i c1 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 8)), key);
+                    __m256i c2 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 16)), key);
+                    __m256i c3 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 24)), key);
+                    __m256i any = _mm256_or_si256(_mm256_or_si256(c0, c1), _mm256_or_si256(c2, c3));
+                    if(_mm256_testz_si256(any, any)) continue;
+                    unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(c0)))
+                                  | static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(c1))) << 8
+                                  | static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(c2))) << 16
+                                  | static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(c3))) << 24;
+                    return first + first_bit(mask);
+                }
+                // less than 32 elements left: the SSE2 kernel handles 16 more, the scalar loop the rest.
+                return lsearch_i32_sse2(first, last, value);
+            }
+#endif
+
+            /// Picks the best kernel the running CPU supports.
+            lsearch_i32_fn select_lsearch_i32( const char ** name )
+            {
+#ifdef SA_X86_SIMD
+                __builtin_cpu_init();
+                if(__builtin_cpu_supports("avx2")) { *name = "avx2"; return lsearch_i32_avx2; }
+                if(__builtin_cpu_supports("sse2")) { *name = "sse2"; return lsearch_i32_sse2; }
+#endif
+                *name = "scalar";
+                return lsearch_i32_scalar;
+            }
+
+            /// The kernel chosen for this process, resolved once (thread-safe static init).
+            struct lsearch_i32_dispatch {
+                const char * name;
+                lsearch_i32_fn kernel;
+                lsearch_i32_dispatch() : name{ nullptr }, kernel{ select_lsearch_i32(&name) } { /* empty */ }
+            };
+
+            const lsearch_i32_dispatch & dispatch( void )
+            {
+                static const lsearch_i32_dispatch d;
+                return d;
+            }
+        }
+
+        const std::int32_t * lsearch_i32( const std::int32_t * first, const std::int32_t * last, std::int32_t value )
+        {
+            return dispatch().kernel(first, last, value);
         }
-        // if the target is not within the range passed to the function
-        return last;
-    }
 
-    /*!
-     * Returns a pointer to the first element in the range [first, last) that is greater
-       than value, or a pointer to last if no such element is found.
-     * @note The range must be sorted.
-     * @param first Pointer to the begining of the data range.
-     * @param last Pointer just past the last element of the data range.
-     * @param value The value we are looking for.
-     * @return a pointer within the range [first, last].
-     */
-    value_type * ubound( value_type * first, value_type * last, value_type value )
-    {
-        // linear search for the first element that is greater than the target
-        while(first != last) {
-            if(*first > value) return first;
-            else first++;
+        const char * lsearch_i32_isa( void )
+        {
+            return dispatch().name;
         }
-        // if the target is not within the range passed to the function
-        return last;
     }
-}
\ No newline at end of file
+}
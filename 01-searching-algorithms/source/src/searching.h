@@ -1,10 +1,15 @@
 /*!
- * A simple implementation of the following algorithms for array of integers:
+ * A simple implementation of the following algorithms over sorted (or unsorted,
+ * for the linear search) ranges:
  *  + linear search
  *  + upper bound
  *  + lower bound
  *  + binary search
  *
+ * All algorithms are function templates over an iterator, a value type and a
+ * comparison functor, so they work on raw arrays of any type, on `std::vector`,
+ * `sc::vector` or any other random access container.
+ *
  * \author Selan R. dos Santos
  * \date July, 31st.
  */
@@ -12,7 +17,34 @@
 #ifndef SEARCHING_H
 #define SEARCHING_H
 
-#include <iterator>
+#include <iterator>     // std::iterator_traits, std::distance
+#include <functional>   // std::less, std::equal_to
+#include <type_traits>  // std::integral_constant, std::is_pointer, std::is_arithmetic
+#include <cstdint>      // std::int32_t, std::uint32_t
+#include <algorithm>    // std::is_sorted
+#include <cstddef>      // std::size_t
+#include <array>        // std::array
+#include <atomic>       // std::atomic
+#include <utility>      // std::pair
+#include <cmath>        // std::isfinite
+
+// Software prefetch hint used by the logarithmic searches. Define SA_NO_PREFETCH
+// to turn it into a no-op.
+#if defined(SA_NO_PREFETCH) || !(defined(__GNUC__) || defined(__clang__))
+#   define SA_PREFETCH(addr) ((void)0)
+#else
+#   define SA_PREFETCH(addr) __builtin_prefetch(addr)
+#endif
+
+// Asks the compiler to fully unroll the loop that follows, when its trip count is
+// a compile-time constant.
+#if defined(__clang__)
+#   define SA_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#   define SA_UNROLL _Pragma("GCC unroll 64")
+#else
+#   define SA_UNROLL
+#endif
 
 /// Searching Algorithms Namespace
 namespace sa {
@@ -20,23 +52,129 @@ namespace sa {
     /// just an alias for an integer type.
     using value_type = int;
 
+    namespace detail {
+        /// Tag selected when the range is a plain array of arithmetic values.
+        using fast_path = std::true_type;
+        /// Tag selected for any other iterator.
+        using generic_path = std::false_type;
+
+        /// Tells at compile time whether [first,last) is a contiguous array of arithmetic values.
+        template < typename It >
+        struct is_contiguous_arithmetic
+            : std::integral_constant< bool,
+                std::is_pointer< It >::value
+                && std::is_arithmetic< typename std::iterator_traits< It >::value_type >::value >
+        { /* empty */ };
+
+        /// Picks the dispatch tag for iterator `It`.
+        template < typename It >
+        using path_for = typename is_contiguous_arithmetic< It >::type;
+
+        /// Tag selected when a linear search can run on the vectorized 32-bit kernel.
+        struct simd_path { };
+
+        /// Tells whether lsearch() over `It` looking for a `T` with `Equal` can use lsearch_i32().
+        template < typename It, typename T, typename Equal,
+                   typename V = typename std::iterator_traits< It >::value_type >
+        struct is_simd_searchable
+            : std::integral_constant< bool,
+                std::is_pointer< It >::value
+                && ( std::is_same< V, std::int32_t >::value || std::is_same< V, std::uint32_t >::value )
+                && std::is_same< typename std::decay< T >::type, V >::value
+                && ( std::is_same< Equal, std::equal_to<> >::value || std::is_same< Equal, std::equal_to< V > >::value ) >
+        { /* empty */ };
+
+        /// Picks the dispatch tag for a linear search.
+        template < typename It, typename T, typename Equal >
+        using lsearch_path_for = typename std::conditional< is_simd_searchable< It, T, Equal >::value,
+                                                            simd_path, path_for< It > >::type;
+
+        /// Vectorized linear search over 32-bit integers, dispatched at runtime (see searching.cpp).
+        const std::int32_t * lsearch_i32( const std::int32_t * first, const std::int32_t * last, std::int32_t value );
+
+        /// Name of the instruction set lsearch_i32() runs on: "avx2", "sse2" or "scalar".
+        const char * lsearch_i32_isa( void );
+    }
+
     /// Linear search.
-    value_type * lsearch( value_type * first, value_type * last, value_type value );
+    template < typename InputIt, typename T, typename Equal = std::equal_to<> >
+    InputIt lsearch( InputIt first, InputIt last, const T & value, Equal eq = Equal{} );
+
+    /// Tuning of the parallel searches.
+    struct parallel_options {
+        unsigned threads{ 0 };                          //!< Threads to use, counting the caller; 0 means one per hardware thread (on thread_pool::shared()).
+        std::size_t min_chunk{ std::size_t{1} << 16 };  //!< Smallest number of elements handed to a thread at once.
+    };
+
+    /// Parallel linear search; returns the leftmost match, like lsearch().
+    template < typename RandomIt, typename T, typename Equal = std::equal_to<> >
+    RandomIt plsearch( RandomIt first, RandomIt last, const T & value,
+                       const parallel_options & opt = parallel_options{}, Equal eq = Equal{} );
 
     /// Binary search.
-    value_type * bsearch( value_type * first, value_type * last, value_type value );
+    template < typename RandomIt, typename T, typename Compare = std::less<> >
+    RandomIt bsearch( RandomIt first, RandomIt last, const T & value, Compare cmp = Compare{} );
 
     /// Wrapper to hold last and to call bsearchr.
-    value_type * bsearchrwrapper( value_type * first, value_type * last, value_type value );
+    template < typename RandomIt, typename T, typename Compare = std::less<> >
+    RandomIt bsearchrwrapper( RandomIt first, RandomIt last, const T & value, Compare cmp = Compare{} );
 
     /// Recursive binary search.
-    value_type * bsearchr( value_type * first, value_type * last, value_type value );
+    template < typename RandomIt, typename T, typename Compare = std::less<> >
+    RandomIt bsearchr( RandomIt first, RandomIt last, const T & value, Compare cmp = Compare{} );
 
     /// Lower bound.
-    value_type * lbound( value_type * first, value_type * last, value_type value );
+    template < typename RandomIt, typename T, typename Compare = std::less<> >
+    RandomIt lbound( RandomIt first, RandomIt last, const T & value, Compare cmp = Compare{} );
 
     /// Upper bound.
-    value_type * ubound( value_type * first, value_type * last, value_type value );
+    template < typename RandomIt, typename T, typename Compare = std::less<> >
+    RandomIt ubound( RandomIt first, RandomIt last, const T & value, Compare cmp = Compare{} );
+
+    /// Binary search over a table whose size is known at compile time; returns a position.
+    template < typename T, std::size_t N, typename Compare = std::less<> >
+    constexpr std::size_t bsearch_fixed( const T (&table)[N], const T & value, Compare cmp = Compare{} );
+
+    /// Binary search over a `std::array`; returns a position.
+    template < typename T, std::size_t N, typename Compare = std::less<> >
+    constexpr std::size_t bsearch_fixed( const std::array< T, N > & table, const T & value, Compare cmp = Compare{} );
+
+    /// Interpolation search, falls back to binary search after `max_probes` probes.
+    template < typename RandomIt, typename T >
+    RandomIt isearch( RandomIt first, RandomIt last, const T & value, std::size_t max_probes = 8 );
+
+    /// Exponential (galloping) search.
+    template < typename RandomIt, typename T, typename Compare = std::less<> >
+    RandomIt esearch( RandomIt first, RandomIt last, const T & value, Compare cmp = Compare{} );
+
+    /// Binary search of every key in [keys_first, keys_last), one result per key written to `out`.
+    template < typename RandomIt, typename ForwardIt, typename OutputIt, typename Compare = std::less<> >
+    OutputIt bsearch_many( RandomIt first, RandomIt last, ForwardIt keys_first, ForwardIt keys_last,
+                           OutputIt out, Compare cmp = Compare{} );
+
+    /// Lower and upper bound of `value`, found with a shared binary search.
+    template < typename RandomIt, typename T, typename Compare = std::less<> >
+    std::pair< RandomIt, RandomIt > equal_range( RandomIt first, RandomIt last, const T & value, Compare cmp = Compare{} );
+
+    /// Number of elements equivalent to `value` in a sorted range.
+    template < typename RandomIt, typename T, typename Compare = std::less<> >
+    std::size_t count_sorted( RandomIt first, RandomIt last, const T & value, Compare cmp = Compare{} );
+
+    /// count_sorted() of every key in [keys_first, keys_last), one count per key written to `out`.
+    template < typename RandomIt, typename ForwardIt, typename OutputIt, typename Compare = std::less<> >
+    OutputIt count_sorted_many( RandomIt first, RandomIt last, ForwardIt keys_first, ForwardIt keys_last,
+                                OutputIt out, Compare cmp = Compare{} );
+
+    /// Lower bound, linear version.
+    template < typename InputIt, typename T, typename Compare = std::less<> >
+    InputIt lbound_linear( InputIt first, InputIt last, const T & value, Compare cmp = Compare{} );
+
+    /// Upper bound, linear version.
+    template < typename InputIt, typename T, typename Compare = std::less<> >
+    InputIt ubound_linear( InputIt first, InputIt last, const T & value, Compare cmp = Compare{} );
 }
 
+#include "thread_pool.h"
+#include "searching.inl"
+
 #endif // SEARCHING_H
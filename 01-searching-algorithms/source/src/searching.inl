@@ -0,0 +1,770 @@
+/*!
+ * \file searching.inl
+ * Binary search, Linear search, Upper bound, lower bound implementation.
+ *
+ * Every public function forwards to a `detail` overload selected by a tag
+ * (see detail::path_for): contiguous arithmetic ranges take a pointer based
+ * fast path, any other iterator takes the portable loop. Linear searches over
+ * 32-bit integers go one step further and run on the SIMD kernel compiled in
+ * searching.cpp.
+ * \author Selan R. dos Santos
+ * \date June 17th, 2021.
+ */
+
+#include "searching.h"
+
+namespace sa {
+
+    namespace detail {
+        //=== Linear search
+
+        /// Portable linear search, one element per iteration.
+        template < typename InputIt, typename T, typename Equal >
+        InputIt lsearch( InputIt first, InputIt last, const T & value, Equal eq, generic_path )
+        {
+            while(first != last) {
+                if(eq(*first, value)) return first;
+                else first++;
+            }
+            return first;
+        }
+
+        /// Contiguous linear search, unrolled four elements at a time.
+        template < typename Ptr, typename T, typename Equal >
+        Ptr lsearch( Ptr first, Ptr last, const T & value, Equal eq, fast_path )
+        {
+            for( ; last - first >= 4; first += 4) {
+                if(eq(first[0], value)) return first;
+                if(eq(first[1], value)) return first + 1;
+                if(eq(first[2], value)) return first + 2;
+                if(eq(first[3], value)) return first + 3;
+            }
+            return lsearch(first, last, value, eq, generic_path{});
+        }
+
+        /// Linear search on 32-bit integers, handed over to the SIMD kernel.
+        template < typename Ptr, typename T, typename Equal >
+        Ptr lsearch( Ptr first, Ptr last, const T & value, Equal, simd_path )
+        {
+            auto * begin = reinterpret_cast< const std::int32_t * >(first);
+            auto * end = reinterpret_cast< const std::int32_t * >(last);
+            return first + (lsearch_i32(begin, end, static_cast< std::int32_t >(value)) - begin);
+        }
+
+        //=== Lower/upper bound
+
+        /// Portable lower bound.
+        template < typename RandomIt, typename T, typename Compare >
+        RandomIt lbound( RandomIt first, RandomIt last, const T & value, Compare cmp, generic_path )
+        {
+            auto len = std::distance(first, last);
+            while(len > 0) {
+                auto half = len / 2;
+                RandomIt mid = first + half;
+                if(cmp(*mid, value)) {
+                    first = ++mid;
+                    len -= half + 1;
+                }
+                else len = half;
+            }
+            return first;
+        }
+
+        /*!
+         * Contiguous lower bound.
+         *
+         * The range is halved at each step without branching on the comparison
+         * result: the next base is picked with a conditional move, so there is
+         * nothing for the branch predictor to miss. Both candidate midpoints of the
+         * next step are prefetched while the current one is being compared.
+         */
+        template < typename Ptr, typename T, typename Compare >
+        Ptr lbound( Ptr first, Ptr last, const T & value, Compare cmp, fast_path )
+        {
+            auto len = last - first;
+            if(len == 0) return last;
+            Ptr base = first;
+            while(len > 1) {
+                auto half = len / 2;
+                // the next probe lands either at base + len/4 or at base + half + len/4.
+                SA_PREFETCH(base + half / 2);
+                SA_PREFETCH(base + half + half / 2);
+                base = cmp(base[half], value) ? base + half : base;
+                len -= half;
+            }
+            return base + cmp(*base, value);
+        }
+
+        /// Portable upper bound.
+        template < typename RandomIt, typename T, typename Compare >
+        RandomIt ubound( RandomIt first, RandomIt last, const T & value, Compare cmp, generic_path )
+        {
+            auto len = std::distance(first, last);
+            while(len > 0) {
+                auto half = len / 2;
+                RandomIt mid = first + half;
+                if(!cmp(value, *mid)) {
+                    first = ++mid;
+                    len -= half + 1;
+                }
+                else len = half;
+            }
+            return first;
+        }
+
+        /// Contiguous upper bound, same branchless strategy used by the lower bound.
+        template < typename Ptr, typename T, typename Compare >
+        Ptr ubound( Ptr first, Ptr last, const T & value, Compare cmp, fast_path )
+        {
+            auto len = last - first;
+            if(len == 0) return last;
+            Ptr base = first;
+            while(len > 1) {
+                auto half = len / 2;
+                SA_PREFETCH(base + half / 2);
+                SA_PREFETCH(base + half + half / 2);
+                base = cmp(value, base[half]) ? base : base + half;
+                len -= half;
+            }
+            return base + !cmp(value, *base);
+        }
+
+        //=== Binary search
+
+        /// Portable binary search, stops as soon as the target is hit.
+        template < typename RandomIt, typename T, typename Compare >
+        RandomIt bsearch( RandomIt first, RandomIt last, const T & value, Compare cmp, generic_path )
+        {
+            RandomIt saved_last = last;
+            while(first != last) {
+                // iterator to the middle
+                RandomIt mid = first + std::distance(first, last)/2;
+                // middle element is greater than target, search in left subarray
+                if(cmp(value, *mid)) last = mid;
+                // middle element is less than target, search in right subarray
+                else if(cmp(*mid, value)) first = ++mid;
+                // the middle element is the target
+                else return mid;
+            }
+            // if the target is not within the range passed to the function
+            return saved_last;
+        }
+
+        /// Contiguous binary search: a branchless lower bound plus a single equality check.
+        template < typename Ptr, typename T, typename Compare >
+        Ptr bsearch( Ptr first, Ptr last, const T & value, Compare cmp, fast_path )
+        {
+            Ptr lb = lbound(first, last, value, cmp, fast_path{});
+            return (lb != last && !cmp(value, *lb)) ? lb : last;
+        }
+
+        /// Recursive binary search, returns `not_found` if the target is missing.
+        template < typename RandomIt, typename T, typename Compare >
+        RandomIt bsearchr( RandomIt first, RandomIt last, const T & value, Compare cmp, RandomIt not_found )
+        {
+            if(first != last) {
+                // iterator to the middle
+                RandomIt mid = first + std::distance(first, last)/2;
+                // middle element is greater than target, search in left subarray
+                if(cmp(value, *mid)) return bsearchr(first, mid, value, cmp, not_found);
+                // middle element is less than target, search in right subarray
+                else if(cmp(*mid, value)) return bsearchr(++mid, last, value, cmp, not_found);
+                // the middle element is the target
+                else return mid;
+            // if the target is not within the range passed to the function
+            } else return not_found;
+        }
+    }
+
+    namespace detail {
+        /*!
+         * Branchless lower bound on the first N elements of `table`, followed by an
+         * equality check. The sequence of range lengths depends on N only, so when
+         * N is a compile-time constant the loop has a constant trip count and is
+         * fully unrolled: no recursion, no loop counter, no data-dependent branch.
+         */
+        template < std::size_t N, typename Table, typename T, typename Compare >
+        constexpr std::size_t bsearch_fixed( const Table & table, const T & value, Compare cmp )
+        {
+            if(N == 0) return 0;
+            std::size_t base = 0;
+            std::size_t len = N;
+            SA_UNROLL
+            while(len > 1) {
+                std::size_t half = len / 2;
+                base = cmp(table[base + half], value) ? base + half : base;
+                len -= half;
+            }
+            std::size_t lb = base + cmp(table[base], value);
+            return (lb < N && !cmp(value, table[lb])) ? lb : N;
+        }
+    }
+
+    /*!
+     * Performs a binary search for target-value in a table whose size is known at
+       compile time (a static array), and returns the position of value in the table,
+       or N if no such element is found.
+     *
+     * The function is `constexpr`, so lookups in constant tables may be resolved at
+     * compile time; at runtime the search is recursion-free and fully unrolled.
+     * @note The table **must** be sorted with respect to `cmp`.
+     * @param table The table to search in.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return the position of target-value in [0, N) or N if target is not found.
+     */
+    template < typename T, std::size_t N, typename Compare >
+    constexpr std::size_t bsearch_fixed( const T (&table)[N], const T & value, Compare cmp )
+    {
+        return detail::bsearch_fixed< N >(table, value, cmp);
+    }
+
+    /*!
+     * Same as above, for a `std::array`.
+     * @param table The table to search in.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return the position of target-value in [0, N) or N if target is not found.
+     */
+    template < typename T, std::size_t N, typename Compare >
+    constexpr std::size_t bsearch_fixed( const std::array< T, N > & table, const T & value, Compare cmp )
+    {
+        return detail::bsearch_fixed< N >(table, value, cmp);
+    }
+
+    /*!
+     * Performs an interpolation search for target-value in [first;last) and returns an
+       iterator to the location of value in the range [first,last], or an iterator to last
+       if no such element is found.
+     *
+     * Each probe is placed where the value would be if the keys were evenly spread
+     * between the two ends of what is left of the range, so uniformly distributed keys
+     * are found in O(log log n) probes. Skewed keys could need O(n) probes, so after
+     * `max_probes` of them the search finishes as a regular binary search.
+     * @note The range **must** be sorted in ascending order, and its values must be
+     *    arithmetic (or at least convertible to double).
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param max_probes How many interpolation probes are tried before falling back to binary search.
+     * @return an iterator to the location of target-value in the range [first, last)
+     *     or an iterator to last if target is not found.
+     */
+    template < typename RandomIt, typename T >
+    RandomIt isearch( RandomIt first, RandomIt last, const T & value, std::size_t max_probes )
+    {
+        if(first == last) return last;
+        // [lo; hi] is the closed range still to be searched.
+        RandomIt lo = first;
+        RandomIt hi = last - 1;
+        for(std::size_t probe = 0; probe < max_probes; probe++) {
+            // the value is out of what is left of the range: not present.
+            if(value < *lo || *hi < value) return last;
+            if(!(*lo < *hi)) return (*lo < value || value < *lo) ? last : lo;
+            // offset of the probe, proportional to where value sits between *lo and *hi.
+            double span = static_cast<double>(*hi) - static_cast<double>(*lo);
+            double ratio = (static_cast<double>(value) - static_cast<double>(*lo)) / span;
+            // distinct keys may convert to the same double (64-bit keys past 2^53): no
+            // usable interpolation, so finish with the binary search.
+            if(!(span > 0) || !std::isfinite(ratio)) break;
+            ratio = std::min(1.0, std::max(0.0, ratio));
+            auto offset = static_cast< typename std::iterator_traits<RandomIt>::difference_type >(ratio * (hi - lo));
+            offset = std::min(offset, hi - lo);
+            RandomIt probe_it = lo + offset;
+            if(*probe_it < value) {
+                if(probe_it == hi) return last;
+                lo = probe_it + 1;
+            }
+            else if(value < *probe_it) {
+                if(probe_it == lo) return last;
+                hi = probe_it - 1;
+            }
+            else return probe_it;
+        }
+        // probe budget exhausted, or interpolation impossible.
+        RandomIt end = hi + 1;
+        RandomIt result = bsearch(lo, end, value);
+        return result == end ? last : result;
+    }
+
+    /*!
+     * Performs an exponential (galloping) search for target-value in [first;last) and
+       returns an iterator to the location of value in the range [first,last], or an
+       iterator to last if no such element is found.
+     *
+     * Probes positions 1, 2, 4, 8, ... until one is not less than the target, then runs
+     * a binary search between the last two probes. The cost is O(log i), where i is the
+     * position of the target, so it beats binary search when targets are near the front.
+     * @note The range **must** be sorted with respect to `cmp`.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator to the location of target-value in the range [first, last)
+     *     or an iterator to last if target is not found.
+     */
+    template < typename RandomIt, typename T, typename Compare >
+    RandomIt esearch( RandomIt first, RandomIt last, const T & value, Compare cmp )
+    {
+        auto n = std::distance(first, last);
+        if(n == 0) return last;
+        if(!cmp(*first, value)) return cmp(value, *first) ? last : first;
+        // invariant: *(first + bound/2) < value.
+        decltype(n) bound = 1;
+        while(bound < n && cmp(*(first + bound), value)) bound *= 2;
+        RandomIt lo = first + bound / 2 + 1;
+        RandomIt hi = bound < n ? first + bound + 1 : last;
+        RandomIt result = bsearch(lo, hi, value, cmp);
+        return result == hi ? last : result;
+    }
+
+    namespace detail {
+        //=== Batched binary search
+
+        /// Number of binary searches advanced in lockstep by bsearch_many().
+        constexpr int BATCH_WIDTH = 8;
+
+        /// Maps a lower bound found for `key` into the bsearch() contract.
+        template < typename RandomIt, typename T, typename Compare >
+        RandomIt hit_or_last( RandomIt lb, RandomIt last, const T & key, Compare cmp )
+        {
+            return (lb != last && !cmp(key, *lb)) ? lb : last;
+        }
+
+        /*!
+         * Sorted keys: a single sweep that never moves back. When the keys are dense
+         * with respect to the range (k*log2(n) > n) the cursor walks forward one
+         * element at a time, like a merge; otherwise each key is searched for in
+         * what is left of the range.
+         */
+        template < typename RandomIt, typename ForwardIt, typename OutputIt, typename Compare >
+        OutputIt bsearch_sweep( RandomIt first, RandomIt last, ForwardIt keys_first, ForwardIt keys_last,
+                                OutputIt out, Compare cmp )
+        {
+            auto n = std::distance(first, last);
+            auto k = std::distance(keys_first, keys_last);
+            auto log_n = decltype(n){ 1 };
+            while((decltype(n){ 1 } << log_n) < n) log_n++;
+            bool merge = k * log_n > n;
+
+            RandomIt cursor = first;
+            for( ; keys_first != keys_last; ++keys_first) {
+                if(merge) { while(cursor != last && cmp(*cursor, *keys_first)) ++cursor; }
+                else cursor = sa::lbound(cursor, last, *keys_first, cmp);
+                *out++ = hit_or_last(cursor, last, *keys_first, cmp);
+            }
+            return out;
+        }
+
+        /// Unsorted keys, portable path: one binary search per key.
+        template < typename RandomIt, typename ForwardIt, typename OutputIt, typename Compare >
+        OutputIt bsearch_batch( RandomIt first, RandomIt last, ForwardIt keys_first, ForwardIt keys_last,
+                                OutputIt out, Compare cmp, generic_path )
+        {
+            for( ; keys_first != keys_last; ++keys_first)
+                *out++ = bsearch(first, last, *keys_first, cmp, generic_path{});
+            return out;
+        }
+
+        /*!
+         * Unsorted keys, contiguous path: up to BATCH_WIDTH branchless lower bounds
+         * advance in lockstep. All of them start from the same range length, so they
+         * share the loop counter; the probes of the next level are prefetched for
+         * every key before any of them is compared, so the cache misses of the whole
+         * group overlap instead of being paid one after the other.
+         */
+        template < typename Ptr, typename ForwardIt, typename OutputIt, typename Compare >
+        OutputIt bsearch_batch( Ptr first, Ptr last, ForwardIt keys_first, ForwardIt keys_last,
+                                OutputIt out, Compare cmp, fast_path )
+        {
+            const auto n = last - first;
+            if(n == 0) {
+                for( ; keys_first != keys_last; ++keys_first) *out++ = last;
+                return out;
+            }
+            ForwardIt keys[BATCH_WIDTH];
+            Ptr base[BATCH_WIDTH];
+            while(keys_first != keys_last) {
+                // gather the next group of keys.
+                int m = 0;
+                for( ; m < BATCH_WIDTH && keys_first != keys_last; ++m, ++keys_first) {
+                    keys[m] = keys_first;
+                    base[m] = first;
+                }
+                auto len = n;
+                while(len > 1) {
+                    auto half = len / 2;
+                    for(int i = 0; i < m; i++) {
+                        SA_PREFETCH(base[i] + half / 2);
+                        SA_PREFETCH(base[i] + half + half / 2);
+                    }
+                    for(int i = 0; i < m; i++)
+                        base[i] = cmp(base[i][half], *keys[i]) ? base[i] + half : base[i];
+                    len -= half;
+                }
+                for(int i = 0; i < m; i++) {
+                    Ptr lb = base[i] + cmp(*base[i], *keys[i]);
+                    *out++ = hit_or_last(lb, last, *keys[i], cmp);
+                }
+            }
+            return out;
+        }
+    }
+
+    /*!
+     * Performs a binary search for each key in [keys_first;keys_last) within [first;last)
+       and writes, for each key, an iterator to its location in [first,last), or an iterator
+       to last if the key is not found (the same convention used by bsearch()).
+     *
+     * Keys that are already sorted are resolved by a single forward sweep over the range.
+     * Otherwise, for contiguous arithmetic ranges, several searches are interleaved with
+     * software prefetching to hide the memory latency of each probe.
+     * @note The range **must** be sorted with respect to `cmp`; the keys may be in any order.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param keys_first Iterator to the first key we are looking for.
+     * @param keys_last Iterator just past the last key we are looking for.
+     * @param out Output iterator that receives one result per key, in the order of the keys.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator just past the last result written.
+     */
+    template < typename RandomIt, typename ForwardIt, typename OutputIt, typename Compare >
+    OutputIt bsearch_many( RandomIt first, RandomIt last, ForwardIt keys_first, ForwardIt keys_last,
+                           OutputIt out, Compare cmp )
+    {
+        if(std::is_sorted(keys_first, keys_last, cmp))
+            return detail::bsearch_sweep(first, last, keys_first, keys_last, out, cmp);
+        return detail::bsearch_batch(first, last, keys_first, keys_last, out, cmp, detail::path_for<RandomIt>{});
+    }
+
+    /*!
+     * Performs a linear search for target-value in [first;last) and returns an iterator
+       to the location of value in the range [first,last], or an iterator to last if no
+       such element is found.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param eq A function that returns true if both parameters are **equal**.
+     * @return an iterator to the location of target-value in the range [first, last)
+     *     or an iterator to last if target is not found.
+     */
+    template < typename InputIt, typename T, typename Equal >
+    InputIt lsearch( InputIt first, InputIt last, const T & value, Equal eq )
+    {
+        return detail::lsearch(first, last, value, eq, detail::lsearch_path_for<InputIt, T, Equal>{});
+    }
+
+    /*!
+     * Performs a linear search for target-value in [first;last) split across `opt.threads`
+       threads, and returns an iterator to the leftmost location of value in the range
+       [first,last], or an iterator to last if no such element is found.
+     *
+     * The caller runs one of the threads; the others are the workers of
+     * thread_pool::with_workers(opt.threads - 1), or of thread_pool::shared() when
+     * opt.threads is 0.
+     *
+     * The range is cut into chunks that the threads (the caller included) claim in
+     * increasing order. A thread that finds the value records its position if it is the
+     * leftmost so far; from then on no chunk starting past that position is claimed, so
+     * the search stops early while every chunk before the hit is still fully scanned.
+     * Ranges shorter than two chunks, or a single thread, fall back to lsearch().
+     * @note Do not call this from a task running on thread_pool::shared() or thread_pool::with_workers().
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param opt Number of threads and minimum chunk size.
+     * @param eq A function that returns true if both parameters are **equal**.
+     * @return an iterator to the first location of target-value in the range [first, last)
+     *     or an iterator to last if target is not found.
+     */
+    template < typename RandomIt, typename T, typename Equal >
+    RandomIt plsearch( RandomIt first, RandomIt last, const T & value,
+                       const parallel_options & opt, Equal eq )
+    {
+        const std::size_t n = std::distance(first, last);
+        const std::size_t min_chunk = opt.min_chunk == 0 ? 1 : opt.min_chunk;
+        if(n < 2 * min_chunk) return lsearch(first, last, value, eq);
+        // the caller is one of the threads: the others come from a pool with exactly that many workers.
+        unsigned threads = opt.threads ? opt.threads : thread_pool::shared().size();
+        if(threads <= 1) return lsearch(first, last, value, eq);
+        thread_pool & pool = opt.threads ? thread_pool::with_workers(threads - 1) : thread_pool::shared();
+
+        // a few chunks per thread, so that an early hit cancels most of the work.
+        std::size_t chunk = std::max(min_chunk, n / (8 * std::size_t{ threads }));
+        std::size_t n_chunks = (n + chunk - 1) / chunk;
+        if(threads > n_chunks) threads = static_cast<unsigned>(n_chunks);
+
+        std::atomic< std::size_t > next{ 0 };   // next chunk to be claimed.
+        std::atomic< std::size_t > found{ n };  // leftmost hit so far.
+        auto worker = [&]{
+            while(true) {
+                std::size_t start = next.fetch_add(1) * chunk;
+                if(start >= n || start >= found.load(std::memory_order_relaxed)) return;
+                RandomIt chunk_last = first + std::min(start + chunk, n);
+                RandomIt hit = lsearch(first + start, chunk_last, value, eq);
+                if(hit == chunk_last) continue;
+                std::size_t pos = std::distance(first, hit);
+                std::size_t current = found.load();
+                while(pos < current && !found.compare_exchange_weak(current, pos)) { /* retry */ }
+                return;
+            }
+        };
+
+        std::vector< std::future< void > > pending;
+        for(unsigned i = 1; i < threads; i++) pending.push_back(pool.submit(worker));
+        worker();
+        for(auto & f : pending) f.get();
+        return first + found.load();
+    }
+
+    /*!
+     * Performs a binary search for target-value in [first;last) and returns an iterator
+        to the location of value in the range [first,last], or an iterator to last if no
+        such element is found.
+     * @note The range **must** be sorted with respect to `cmp`.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator to the location of target-value in the range [first, last)
+     *     or an iterator to last if target is not found.
+     */
+    template < typename RandomIt, typename T, typename Compare >
+    RandomIt bsearch( RandomIt first, RandomIt last, const T & value, Compare cmp )
+    {
+        return detail::bsearch(first, last, value, cmp, detail::path_for<RandomIt>{});
+    }
+
+    /*!
+     * A wrapper function that holds the position of last and calls the actual
+       recursive binary search (bsearchr).
+     * @note The range must be sorted.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator to the location of target-value in the range [first, last)
+     *     or an iterator to last if target is not found.
+     */
+    template < typename RandomIt, typename T, typename Compare >
+    RandomIt bsearchrwrapper( RandomIt first, RandomIt last, const T & value, Compare cmp )
+    {
+        return bsearchr(first, last, value, cmp);
+    }
+
+    /*!
+     * Performs a recursive binary search for target-value in [first;last) and returns an iterator
+       to the location of value in the range [first,last], or an iterator to last if no such
+       element is found.
+     * @note The range must be sorted.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator to the location of target-value in the range [first, last)
+     *     or an iterator to last if target is not found.
+     */
+    template < typename RandomIt, typename T, typename Compare >
+    RandomIt bsearchr( RandomIt first, RandomIt last, const T & value, Compare cmp )
+    {
+        return detail::bsearchr(first, last, value, cmp, last);
+    }
+
+    /*!
+     * Returns an iterator to the first element in the range [first, last) that is not less
+       than (i.e. greater or equal to) value, or an iterator to last if no such element is found.
+     * @note The range must be sorted.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator to the location of the first element that is not less than 'value'
+     *    in the range [first, last) or an iterator to last if there is no such element in
+     *    this range.
+     */
+    template < typename RandomIt, typename T, typename Compare >
+    RandomIt lbound( RandomIt first, RandomIt last, const T & value, Compare cmp )
+    {
+        return detail::lbound(first, last, value, cmp, detail::path_for<RandomIt>{});
+    }
+
+    /*!
+     * Returns an iterator to the first element in the range [first, last) that is greater
+       than value, or an iterator to last if no such element is found.
+     * @note The range must be sorted.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator within the range [first, last].
+     */
+    template < typename RandomIt, typename T, typename Compare >
+    RandomIt ubound( RandomIt first, RandomIt last, const T & value, Compare cmp )
+    {
+        return detail::ubound(first, last, value, cmp, detail::path_for<RandomIt>{});
+    }
+
+    namespace detail {
+        //=== Equal range
+
+        /*!
+         * Portable equal range: a single binary search narrows the range until its
+         * middle element is equivalent to value. From there the lower bound can only
+         * be to the left of the middle and the upper bound to its right, so the two
+         * searches only cover what is left.
+         */
+        template < typename RandomIt, typename T, typename Compare >
+        std::pair< RandomIt, RandomIt > equal_range( RandomIt first, RandomIt last, const T & value,
+                                                     Compare cmp, generic_path )
+        {
+            auto len = std::distance(first, last);
+            while(len > 0) {
+                auto half = len / 2;
+                RandomIt mid = first + half;
+                if(cmp(*mid, value)) {
+                    first = mid + 1;
+                    len -= half + 1;
+                }
+                else if(cmp(value, *mid)) len = half;
+                // the shared prefix ends here: split into the two bounds.
+                else return { lbound(first, mid, value, cmp, generic_path{}),
+                              ubound(mid + 1, first + len, value, cmp, generic_path{}) };
+            }
+            return { first, first };
+        }
+
+        /*!
+         * Contiguous equal range: the branchless lower and upper bounds advance in
+         * lockstep. Both start from the same range length and probe the very same
+         * elements until they diverge, so the shared prefix costs one cache miss per
+         * level instead of two, and the two independent chains overlap afterwards.
+         */
+        template < typename Ptr, typename T, typename Compare >
+        std::pair< Ptr, Ptr > equal_range( Ptr first, Ptr last, const T & value, Compare cmp, fast_path )
+        {
+            auto len = last - first;
+            if(len == 0) return { last, last };
+            Ptr lo = first;
+            Ptr hi = first;
+            while(len > 1) {
+                auto half = len / 2;
+                SA_PREFETCH(lo + half / 2);
+                SA_PREFETCH(lo + half + half / 2);
+                SA_PREFETCH(hi + half / 2);
+                SA_PREFETCH(hi + half + half / 2);
+                lo = cmp(lo[half], value) ? lo + half : lo;
+                hi = cmp(value, hi[half]) ? hi : hi + half;
+                len -= half;
+            }
+            return { lo + cmp(*lo, value), hi + !cmp(value, *hi) };
+        }
+    }
+
+    /*!
+     * Returns the range of elements equivalent to value in [first, last), i.e. the pair
+       (lbound(value), ubound(value)), without running two full searches: both bounds
+       share the probes of the common prefix of their descent.
+     * @note The range must be sorted.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return a pair of iterators delimiting the elements equivalent to value; both are the
+     *    position where value would be inserted if there is no such element.
+     */
+    template < typename RandomIt, typename T, typename Compare >
+    std::pair< RandomIt, RandomIt > equal_range( RandomIt first, RandomIt last, const T & value, Compare cmp )
+    {
+        return detail::equal_range(first, last, value, cmp, detail::path_for<RandomIt>{});
+    }
+
+    /*!
+     * Returns the number of elements equivalent to value in [first, last).
+     * @note The range must be sorted.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return the number of occurrences of value.
+     */
+    template < typename RandomIt, typename T, typename Compare >
+    std::size_t count_sorted( RandomIt first, RandomIt last, const T & value, Compare cmp )
+    {
+        auto range = sa::equal_range(first, last, value, cmp);
+        return static_cast< std::size_t >(std::distance(range.first, range.second));
+    }
+
+    /*!
+     * Counts the occurrences of each key in [keys_first;keys_last) within [first;last)
+       and writes one count per key to out, in the order of the keys (a histogram of
+       the keys over the range).
+     *
+     * Keys that are already sorted are resolved by a single forward sweep: the search
+     * for each key starts where the previous one ended.
+     * @note The range **must** be sorted with respect to `cmp`; the keys may be in any order.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param keys_first Iterator to the first key we are looking for.
+     * @param keys_last Iterator just past the last key we are looking for.
+     * @param out Output iterator that receives one count per key.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator just past the last count written.
+     */
+    template < typename RandomIt, typename ForwardIt, typename OutputIt, typename Compare >
+    OutputIt count_sorted_many( RandomIt first, RandomIt last, ForwardIt keys_first, ForwardIt keys_last,
+                                OutputIt out, Compare cmp )
+    {
+        bool sorted = std::is_sorted(keys_first, keys_last, cmp);
+        for( ; keys_first != keys_last; ++keys_first) {
+            auto range = sa::equal_range(first, last, *keys_first, cmp);
+            *out++ = static_cast< std::size_t >(std::distance(range.first, range.second));
+            // later keys are not smaller: nothing before this lower bound matters anymore.
+            if(sorted) first = range.first;
+        }
+        return out;
+    }
+
+    /*!
+     * Linear version of lbound(), kept around for benchmarking purposes.
+     * @note The range must be sorted.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator to the location of the first element that is not less than 'value'
+     *    in the range [first, last) or an iterator to last if there is no such element in
+     *    this range.
+     */
+    template < typename InputIt, typename T, typename Compare >
+    InputIt lbound_linear( InputIt first, InputIt last, const T & value, Compare cmp )
+    {
+        // linear search for the first element that is not less than the target
+        while(first != last) {
+            if(!cmp(*first, value)) return first;
+            else first++;
+        }
+        // if the target is not within the range passed to the function
+        return last;
+    }
+
+    /*!
+     * Linear version of ubound(), kept around for benchmarking purposes.
+     * @note The range must be sorted.
+     * @param first Iterator to the begining of the data range.
+     * @param last Iterator just past the last element of the data range.
+     * @param value The value we are looking for.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return an iterator within the range [first, last].
+     */
+    template < typename InputIt, typename T, typename Compare >
+    InputIt ubound_linear( InputIt first, InputIt last, const T & value, Compare cmp )
+    {
+        // linear search for the first element that is greater than the target
+        while(first != last) {
+            if(cmp(value, *first)) return first;
+            else first++;
+        }
+        // if the target is not within the range passed to the function
+        return last;
+    }
+}
@@ -0,0 +1,74 @@
+/*!
+ * \file thread_pool.cpp
+ * Fixed-size thread pool used by the parallel searches.
+ * \author Selan R. dos Santos
+ * \date July, 31st.
+ */
+
+#include "thread_pool.h"
+
+namespace sa {
+
+    thread_pool::thread_pool( unsigned n_threads )
+        : m_stop{ false }
+    {
+        if(n_threads == 0) n_threads = 1;
+        for(unsigned i = 0; i < n_threads; i++)
+            m_workers.emplace_back([this]{ work(); });
+    }
+
+    thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard< std::mutex > lock{ m_mutex };
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for(auto & worker : m_workers) worker.join();
+    }
+
+    std::future< void > thread_pool::submit( std::function< void() > task )
+    {
+        std::packaged_task< void() > packaged{ std::move(task) };
+        std::future< void > result = packaged.get_future();
+        {
+            std::lock_guard< std::mutex > lock{ m_mutex };
+            m_tasks.push(std::move(packaged));
+        }
+        m_cv.notify_one();
+        return result;
+    }
+
+    thread_pool & thread_pool::shared( void )
+    {
+        static thread_pool pool{ std::thread::hardware_concurrency() };
+        return pool;
+    }
+
+    thread_pool & thread_pool::with_workers( unsigned n_threads )
+    {
+        static std::mutex mutex;
+        static std::map< unsigned, std::unique_ptr< thread_pool > > pools;
+        if(n_threads == 0) n_threads = 1;
+        std::lock_guard< std::mutex > lock{ mutex };
+        auto & pool = pools[n_threads];
+        if(!pool) pool.reset(new thread_pool{ n_threads });
+        return *pool;
+    }
+
+    void thread_pool::work( void )
+    {
+        while(true) {
+            std::packaged_task< void() > task;
+            {
+                std::unique_lock< std::mutex > lock{ m_mutex };
+                m_cv.wait(lock, [this]{ return m_stop || !m_tasks.empty(); });
+                // drain the queue before leaving.
+                if(m_tasks.empty()) return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            task();
+        }
+    }
+}
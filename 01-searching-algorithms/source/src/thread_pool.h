@@ -0,0 +1,58 @@
+/*!
+ * A fixed-size pool of worker threads that run tasks from a shared FIFO queue.
+ * \author Selan R. dos Santos
+ * \date July, 31st.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>   // std::condition_variable
+#include <functional>           // std::function
+#include <future>               // std::future, std::packaged_task
+#include <map>                  // std::map
+#include <memory>               // std::unique_ptr
+#include <mutex>                // std::mutex
+#include <queue>                // std::queue
+#include <thread>               // std::thread
+#include <vector>               // std::vector
+
+/// Searching Algorithms Namespace
+namespace sa {
+
+    /// Fixed-size thread pool.
+    class thread_pool {
+        public:
+            /// Starts `n_threads` workers (at least one).
+            explicit thread_pool( unsigned n_threads );
+            /// Finishes the queued tasks and joins the workers.
+            ~thread_pool();
+
+            thread_pool( const thread_pool & ) = delete;
+            thread_pool & operator=( const thread_pool & ) = delete;
+
+            /// Queues `task`; the returned future becomes ready once it has run.
+            std::future< void > submit( std::function< void() > task );
+
+            /// Number of workers.
+            unsigned size( void ) const { return static_cast<unsigned>(m_workers.size()); }
+
+            /// Pool shared by the parallel algorithms, one worker per hardware thread.
+            static thread_pool & shared( void );
+
+            /// Pool with `n_threads` workers (at least one), started on first use and kept until the program ends.
+            static thread_pool & with_workers( unsigned n_threads );
+
+        private:
+            std::vector< std::thread > m_workers;               //!< The worker threads.
+            std::queue< std::packaged_task< void() > > m_tasks; //!< Tasks waiting for a worker.
+            std::mutex m_mutex;                                 //!< Protects m_tasks and m_stop.
+            std::condition_variable m_cv;                       //!< Signals new tasks or shutdown.
+            bool m_stop;                                        //!< Set when the pool is being destroyed.
+
+            /// Body of every worker: pops and runs tasks until the pool stops.
+            void work( void );
+    };
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,64 @@
+/*!
+ * Compares sa::bsearch over a sorted array with a lookup in the Eytzinger index
+ * built from the same array, for range sizes from 10^3 to 10^8 (the upper limit
+ * may be lowered through the first command line argument).
+ * @date July, 31st.
+ * @author Selan
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include "searching.h"
+#include "eytzinger.h"
+
+/// Receives every result so the optimizer cannot drop the searches.
+volatile std::size_t sink;
+
+/// Average runtime, in nanoseconds per query, of `search` applied to every key.
+template < typename Search >
+double time_queries( const std::vector<int> & keys, Search search )
+{
+    std::size_t acc = 0;
+    auto start = std::chrono::steady_clock::now();
+    //================================================================================
+    for(const auto & key : keys) acc += search(key); // call the function here
+    //================================================================================
+    auto end = std::chrono::steady_clock::now();
+    sink = acc;
+    return std::chrono::duration<double, std::nano>(end - start).count() / keys.size();
+}
+
+int main( int argc, char * argv[] )
+{
+    constexpr std::size_t N_QUERIES = 1000000;
+    std::size_t max_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+
+    std::cout << std::setw(12) << "size" << std::setw(16) << "bsearch (ns)"
+              << std::setw(16) << "eytzinger (ns)" << std::setw(12) << "speedup" << "\n";
+
+    std::mt19937 gen{ 2021 };
+    for(std::size_t size = 1000; size <= max_size; size *= 10) {
+        // even numbers only: about half of the queries miss.
+        std::vector<int> v(size);
+        for(std::size_t i = 0; i < size; i++) v[i] = static_cast<int>(2 * i);
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * size));
+        std::vector<int> keys(N_QUERIES);
+        for(auto & key : keys) key = dist(gen);
+
+        sa::eytzinger_index<int> index(v.begin(), v.end());
+        const int* first = v.data();
+        const int* last = v.data() + v.size();
+
+        double plain = time_queries(keys, [&]( int key ){
+            return static_cast<std::size_t>(sa::bsearch(first, last, key) - first); });
+        double eytz = time_queries(keys, [&]( int key ){ return index.find(key); });
+
+        std::cout << std::setw(12) << size << std::setw(16) << plain
+                  << std::setw(16) << eytz << std::setw(12) << plain / eytz << "\n";
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+/*!
+ * Compares, on small static tables (16 to 1024 entries), the recursive binary
+ * search with the iterative one and with the unrolled compile-time-size search.
+ * Output is CSV with the time per query in nanoseconds.
+ * @date July, 31st.
+ * @author Selan
+ */
+
+#include <iostream>
+#include <array>
+#include <vector>
+#include <random>
+#include "searching.h"
+#include "bench.h"
+
+/// Number of queries in the pool cycled through by every measurement (a power of 2).
+constexpr std::size_t N_QUERIES = 1024;
+
+/// Prints one CSV line.
+void report( const char * name, std::size_t size, const bench::Stats & s )
+{
+    std::cout << name << "," << size << "," << s.min << "," << s.median << ","
+              << s.p95 << "," << s.mean << "," << s.stddev << "\n";
+}
+
+/// Runs the three searches over a table of N entries.
+template < std::size_t N >
+void run_fixed( std::mt19937 & gen )
+{
+    // odd numbers only: half of the queries (the even ones) miss.
+    static std::array< int, N > table;
+    for(std::size_t i = 0; i < N; i++) table[i] = static_cast<int>(2 * i + 1);
+    std::uniform_int_distribution< int > dist(0, static_cast<int>(2 * N));
+    std::vector< int > keys(N_QUERIES);
+    for(auto & key : keys) key = dist(gen);
+
+    const int * first = table.data();
+    const int * last = table.data() + N;
+    auto key = [&]( std::size_t i ){ return keys[i & (N_QUERIES - 1)]; };
+
+    report("bsearchr", N, bench::measure([&]( std::size_t i ){
+        bench::do_not_optimize(sa::bsearchr(first, last, key(i))); }));
+    report("bsearch", N, bench::measure([&]( std::size_t i ){
+        bench::do_not_optimize(sa::bsearch(first, last, key(i))); }));
+    report("bsearch_fixed", N, bench::measure([&]( std::size_t i ){
+        bench::do_not_optimize(sa::bsearch_fixed(table, key(i))); }));
+}
+
+int main( void )
+{
+    std::mt19937 gen{ 2021 };
+    std::cout << "algorithm,size,min_ns,median_ns,p95_ns,mean_ns,stddev_ns\n";
+    run_fixed< 16 >(gen);
+    run_fixed< 32 >(gen);
+    run_fixed< 64 >(gen);
+    run_fixed< 128 >(gen);
+    run_fixed< 256 >(gen);
+    run_fixed< 512 >(gen);
+    run_fixed< 1024 >(gen);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+/*!
+ * Measures the gain of the vectorized linear search over the scalar loop, for
+ * range sizes from 10^3 to 10^7. The target is never present, so both versions
+ * always scan the whole range (worst case).
+ * @date June 17th, 2021.
+ * @author Selan
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <numeric>
+#include "searching.h"
+
+/// Receives every result so the optimizer cannot drop the searches.
+volatile std::ptrdiff_t sink;
+
+/// Average runtime, in milliseconds, of `n_runs` calls to `search`.
+template < typename Search >
+double time_search( const int* first, Search search, int n_runs )
+{
+    std::chrono::duration<double, std::milli> sum{0};
+    for(int i = 0; i < n_runs; i++) {
+        auto start = std::chrono::steady_clock::now();
+        //================================================================================
+        const int* pointer = search(); // call the function here
+        //================================================================================
+        auto end = std::chrono::steady_clock::now();
+        sum += end - start;
+        sink = pointer - first;
+    }
+    return sum.count() / n_runs;
+}
+
+int main( void )
+{
+    constexpr int N_RUNS = 10;
+    const int target = -1; // not present: worst case.
+
+    std::cout << ">>> Vectorized kernel in use: " << sa::detail::lsearch_i32_isa() << "\n";
+    std::cout << std::setw(12) << "size" << std::setw(14) << "scalar (ms)"
+              << std::setw(14) << "simd (ms)" << std::setw(12) << "speedup" << "\n";
+
+    for(std::size_t size = 1000; size <= 10000000; size *= 10) {
+        std::vector<int> v(size);
+        std::iota(v.begin(), v.end(), 0);
+        const int* first = v.data();
+        const int* last = v.data() + v.size();
+
+        double scalar = time_search(first, [&]{
+            return sa::detail::lsearch(first, last, target, std::equal_to<>{}, sa::detail::generic_path{}); }, N_RUNS);
+        double simd = time_search(first, [&]{ return sa::lsearch(first, last, target); }, N_RUNS);
+
+        std::cout << std::setw(12) << size << std::setw(14) << scalar
+                  << std::setw(14) << simd << std::setw(12) << scalar / simd << "\n";
+    }
+    return EXIT_SUCCESS;
+}
@@ -8,12 +8,21 @@
 #include <random>     // random_device, mt19937
 #include <iterator>   // std::begin(), std::end()
 #include <algorithm>
+#include <vector>     // std::vector
+#include <numeric>    // std::iota
+#include <functional> // std::greater
 
 #include "include/tm/test_manager.h"
 
 #include "../src/searching.h"
+#include "../src/eytzinger.h"
 using namespace sa;
 
+// bsearch_fixed() must be usable in constant expressions.
+constexpr value_type FIXED_TABLE[]{ 1, 3, 5, 7, 9, 11, 13 };
+static_assert( bsearch_fixed( FIXED_TABLE, 9 ) == 4, "bsearch_fixed() should find 9 at position 4" );
+static_assert( bsearch_fixed( FIXED_TABLE, 8 ) == 7, "bsearch_fixed() should return N for a missing value" );
+
 int main ( void )
 {
     // Creates a test manager for the DAL class.
@@ -90,6 +99,58 @@ int main ( void )
         EXPECT_EQ( result, last );
     }
 
+    {
+        //=== Test #6
+        BEGIN_TEST(tm, "LongRangeVectorized", "Search every position of a range long enough to exercise the vectorized kernel." );
+        // DISABLE();
+        std::vector< value_type > V( 1000 );
+        std::iota( V.begin(), V.end(), 0 );
+
+        for ( auto i{0u} ; i < V.size() ; ++i )
+        {
+            auto result = lsearch( V.data(), V.data() + V.size(), V[i] );
+            EXPECT_EQ( result, V.data() + i );
+        }
+        EXPECT_EQ( lsearch( V.data(), V.data() + V.size(), -1 ), V.data() + V.size() );
+        // a repeated value: the first occurrence must be returned.
+        V[700] = V[300];
+        EXPECT_EQ( lsearch( V.data(), V.data() + V.size(), V[300] ), V.data() + 300 );
+    }
+
+    {
+        //=== Test #7
+        BEGIN_TEST(tm, "ParallelLeftmost", "Parallel search returns the leftmost of several matches spread over many chunks." );
+        // DISABLE();
+        std::vector< value_type > V( 100000 );
+        std::iota( V.begin(), V.end(), 0 );
+        parallel_options opt;
+        opt.threads = 4;
+        opt.min_chunk = 1000;
+
+        // duplicates of the target, in chunks handled by different threads.
+        V[99000] = V[60000] = V[42123] = -7;
+        EXPECT_EQ( plsearch( V.begin(), V.end(), -7, opt ), V.begin() + 42123 );
+        V[5] = -7;
+        EXPECT_EQ( plsearch( V.begin(), V.end(), -7, opt ), V.begin() + 5 );
+        for ( auto i : { 0, 999, 1000, 54321, 99999 } )
+            EXPECT_EQ( plsearch( V.data(), V.data() + V.size(), V[i], opt ), V.data() + i );
+    }
+
+    {
+        //=== Test #8
+        BEGIN_TEST(tm, "ParallelNotFound", "Parallel search for a missing value, and a range small enough to run serially." );
+        // DISABLE();
+        std::vector< value_type > V( 100000 );
+        std::iota( V.begin(), V.end(), 0 );
+        parallel_options opt;
+        opt.threads = 4;
+        opt.min_chunk = 1000;
+
+        EXPECT_EQ( plsearch( V.begin(), V.end(), -1, opt ), V.end() );
+        EXPECT_EQ( plsearch( V.begin(), V.begin() + 1500, 1499, opt ), V.begin() + 1499 );
+        EXPECT_EQ( plsearch( V.begin(), V.begin() + 1500, 1500, opt ), V.begin() + 1500 );
+    }
+
     tm.summary();
     std::cout << std::endl;
 
@@ -406,6 +467,22 @@ int main ( void )
         EXPECT_EQ( lb_it, expected_lb_it );
     }
 
+    {
+        //=== Test #17
+        BEGIN_TEST(tm3, "LinearVersionAgrees", "Linear and logarithmic lower bound return the same location for every target." );
+        // DISABLE();
+        value_type A[]{ 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5 };
+
+        for ( auto value{0} ; value <= 6 ; ++value )
+        {
+            auto lb_it = lbound( std::begin(A), std::end(A), value );
+            auto linear_lb_it = lbound_linear( std::begin(A), std::end(A), value );
+            auto expected_lb_it = std::lower_bound( std::begin(A), std::end(A), value );
+            EXPECT_EQ( lb_it, linear_lb_it );
+            EXPECT_EQ( lb_it, expected_lb_it );
+        }
+    }
+
     tm3.summary();
     std::cout << std::endl;
 
@@ -637,8 +714,516 @@ int main ( void )
         EXPECT_EQ( ub_it, expected_ub_it );
     }
 
+    {
+        //=== Test #17
+        BEGIN_TEST(tm4, "LinearVersionAgrees", "Linear and logarithmic upper bound return the same location for every target." );
+        // DISABLE();
+        value_type A[]{ 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5 };
+
+        for ( auto value{0} ; value <= 6 ; ++value )
+        {
+            auto ub_it = ubound( std::begin(A), std::end(A), value );
+            auto linear_ub_it = ubound_linear( std::begin(A), std::end(A), value );
+            auto expected_ub_it = std::upper_bound( std::begin(A), std::end(A), value );
+            EXPECT_EQ( ub_it, linear_ub_it );
+            EXPECT_EQ( ub_it, expected_ub_it );
+        }
+    }
+
     tm4.summary();
     std::cout << std::endl;
 
+    // Creates a test manager for the generic (templated) interface.
+    TestManager tm5{ "Generic Search Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm5, "LongRange", "Search a range of long integers." );
+        // DISABLE();
+        long A[]{ 10000000000L, 20000000000L, 30000000000L, 40000000000L };
+
+        for ( const auto & e : A )
+        {
+            EXPECT_EQ( *lsearch( std::begin(A), std::end(A), e ), e );
+            EXPECT_EQ( *bsearch( std::begin(A), std::end(A), e ), e );
+            EXPECT_EQ( *bsearchr( std::begin(A), std::end(A), e ), e );
+        }
+        EXPECT_EQ( bsearch( std::begin(A), std::end(A), 25000000000L ), std::end(A) );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm5, "DoubleRange", "Lower and upper bound on a range of doubles." );
+        // DISABLE();
+        double A[]{ 0.5, 1.5, 1.5, 1.5, 2.5, 3.5 };
+
+        EXPECT_EQ( lbound( std::begin(A), std::end(A), 1.5 ), std::begin(A)+1 );
+        EXPECT_EQ( ubound( std::begin(A), std::end(A), 1.5 ), std::begin(A)+4 );
+        EXPECT_EQ( lbound( std::begin(A), std::end(A), 2.0 ), std::begin(A)+4 );
+        EXPECT_EQ( ubound( std::begin(A), std::end(A), 4.0 ), std::end(A) );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm5, "VectorIterators", "Search through class iterators, which take the generic path." );
+        // DISABLE();
+        std::vector< int > V{ 1, 1, 1, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5 };
+
+        for ( auto value{0} ; value <= 6 ; ++value )
+        {
+            EXPECT_EQ( lbound( V.begin(), V.end(), value ), std::lower_bound( V.begin(), V.end(), value ) );
+            EXPECT_EQ( ubound( V.begin(), V.end(), value ), std::upper_bound( V.begin(), V.end(), value ) );
+            EXPECT_EQ( lsearch( V.begin(), V.end(), value ), std::find( V.begin(), V.end(), value ) );
+            auto result = bsearch( V.begin(), V.end(), value );
+            EXPECT_TRUE( ( result == V.end() ? ( value < 1 or value > 5 ) : *result == value ) );
+        }
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm5, "CustomCompare", "Search a range sorted in descending order." );
+        // DISABLE();
+        value_type A[]{ 9, 7, 7, 5, 3, 3, 1 };
+        std::greater< value_type > cmp;
+
+        for ( auto value{0} ; value <= 10 ; ++value )
+        {
+            EXPECT_EQ( lbound( std::begin(A), std::end(A), value, cmp ), std::lower_bound( std::begin(A), std::end(A), value, cmp ) );
+            EXPECT_EQ( ubound( std::begin(A), std::end(A), value, cmp ), std::upper_bound( std::begin(A), std::end(A), value, cmp ) );
+        }
+        EXPECT_EQ( *bsearch( std::begin(A), std::end(A), 5, cmp ), 5 );
+        EXPECT_EQ( *bsearchr( std::begin(A), std::end(A), 9, cmp ), 9 );
+        EXPECT_EQ( bsearch( std::begin(A), std::end(A), 4, cmp ), std::end(A) );
+        EXPECT_EQ( bsearchr( std::begin(A), std::end(A), 4, cmp ), std::end(A) );
+    }
+
+    tm5.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the batched search.
+    TestManager tm6{ "Batch Search Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm6, "SortedKeys", "Sorted keys, present and missing, are resolved by the forward sweep." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5, 7, 9, 11, 13 };
+        value_type K[]{ 0, 1, 2, 5, 6, 13, 14 };
+        value_type * R[7];
+
+        auto end = bsearch_many( std::begin(A), std::end(A), std::begin(K), std::end(K), std::begin(R) );
+        EXPECT_EQ( end, std::end(R) );
+        for ( auto i{0} ; i < 7 ; ++i )
+            EXPECT_EQ( R[i], bsearch( std::begin(A), std::end(A), K[i] ) );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm6, "UnsortedKeys", "Unsorted keys, more than one batch, on a contiguous range." );
+        // DISABLE();
+        std::vector< value_type > V( 1000 );
+        for ( auto i{0u} ; i < V.size() ; ++i ) V[i] = 2 * i;
+        std::vector< value_type > K( 300 );
+        for ( auto i{0u} ; i < K.size() ; ++i ) K[i] = ( i * 37 ) % 2003 - 1;
+        std::vector< value_type * > R;
+
+        bsearch_many( V.data(), V.data() + V.size(), K.begin(), K.end(), std::back_inserter(R) );
+        EXPECT_EQ( R.size(), K.size() );
+        for ( auto i{0u} ; i < K.size() ; ++i )
+            EXPECT_EQ( R[i], bsearch( V.data(), V.data() + V.size(), K[i] ) );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm6, "GenericIterators", "Unsorted keys searched through class iterators." );
+        // DISABLE();
+        std::vector< value_type > V{ 1, 3, 5, 7, 9, 11, 13 };
+        value_type K[]{ 13, 4, 1, 7, 20 };
+        std::vector< std::vector< value_type >::iterator > R;
+
+        bsearch_many( V.begin(), V.end(), std::begin(K), std::end(K), std::back_inserter(R) );
+        EXPECT_EQ( R.size(), 5u );
+        EXPECT_EQ( R[0], V.begin()+6 );
+        EXPECT_EQ( R[1], V.end() );
+        EXPECT_EQ( R[2], V.begin() );
+        EXPECT_EQ( R[3], V.begin()+3 );
+        EXPECT_EQ( R[4], V.end() );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm6, "EmptyRange", "Every key maps to last on an empty range." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5 };
+        value_type K[]{ 5, 1, 3 };
+        value_type * R[3];
+
+        bsearch_many( std::begin(A), std::begin(A), std::begin(K), std::end(K), std::begin(R) );
+        for ( const auto & r : R )
+            EXPECT_EQ( r, std::begin(A) );
+    }
+
+    tm6.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the Eytzinger index.
+    TestManager tm7{ "Eytzinger Index Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm7, "Bounds", "Lower and upper bound agree with the standard library for every size up to 70." );
+        // DISABLE();
+        for ( auto n{0} ; n <= 70 ; ++n )
+        {
+            // pairs of repeated odd values: 1, 1, 3, 3, 5, 5, ...
+            std::vector< value_type > V( n );
+            for ( auto i{0} ; i < n ; ++i ) V[i] = 2 * ( i / 2 ) + 1;
+            eytzinger_index< value_type > index( V.begin(), V.end() );
+
+            EXPECT_EQ( index.size(), V.size() );
+            for ( auto value{0} ; value <= n + 2 ; ++value )
+            {
+                auto lb = std::lower_bound( V.begin(), V.end(), value );
+                auto ub = std::upper_bound( V.begin(), V.end(), value );
+                EXPECT_EQ( index.lower_bound( value ), std::size_t( lb - V.begin() ) );
+                EXPECT_EQ( index.upper_bound( value ), std::size_t( ub - V.begin() ) );
+            }
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm7, "Find", "Every element is found at its original position; missing ones map to size()." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5, 7, 9, 11, 13, 15, 17, 19 };
+        eytzinger_index< value_type > index( std::begin(A), std::end(A) );
+
+        for ( auto i{0} ; i < 10 ; ++i )
+        {
+            EXPECT_EQ( index.find( A[i] ), std::size_t( i ) );
+            EXPECT_EQ( index.find( A[i] + 1 ), index.size() );
+        }
+        EXPECT_EQ( index.find( 0 ), index.size() );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm7, "CustomCompare", "Index over a range sorted in descending order." );
+        // DISABLE();
+        value_type A[]{ 9, 7, 7, 5, 3, 3, 1 };
+        std::greater< value_type > cmp;
+        eytzinger_index< value_type, std::greater< value_type > > index( std::begin(A), std::end(A), cmp );
+
+        for ( auto value{0} ; value <= 10 ; ++value )
+        {
+            auto lb = std::lower_bound( std::begin(A), std::end(A), value, cmp );
+            auto ub = std::upper_bound( std::begin(A), std::end(A), value, cmp );
+            EXPECT_EQ( index.lower_bound( value ), std::size_t( lb - std::begin(A) ) );
+            EXPECT_EQ( index.upper_bound( value ), std::size_t( ub - std::begin(A) ) );
+        }
+    }
+
+    tm7.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the interpolation search.
+    TestManager tm8{ "Interpolation Search Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm8, "BasicSearch", "Search for all n elements present in the array." );
+        // DISABLE();
+        value_type A[]{ 1, 2, 3, 4, 5, 6, 7 };
+
+        // Looking for each element from A in A.
+        for ( const auto & e : A )
+        {
+            auto result = isearch( std::begin(A), std::end(A), e );
+            EXPECT_EQ( *result, e );
+            EXPECT_EQ( e-1, std::distance(std::begin(A), result ) );
+        }
+    }
+    {
+        //=== Test #2
+        BEGIN_TEST(tm8, "NotPresentToLeft", "Search for an element that is not present, whose value is smaller than the first element of the array." );
+        // DISABLE();
+        value_type A[]{ 1, 2, 3, 4, 5, 6, 7 };
+
+        auto target{-4};
+        auto result = isearch( std::begin(A), std::end(A), target );
+        EXPECT_EQ( result, std::end(A) );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm8, "NotPresentToRight", "Search for an element that is not present, whose value is greater than the last element of the array." );
+        // DISABLE();
+        value_type A[]{ 1, 2, 3, 4, 5, 6, 7 };
+
+        auto target{10};
+        auto result = isearch( std::begin(A), std::end(A), target );
+        EXPECT_EQ( result, std::end(A) );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm8, "NotPresentInBetween", "Search for an element that is not present, whose value is between the first and the last elements of the array." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5, 7, 9, 11 };
+
+        for ( auto i{2} ; i < 11 ; i+=2 )
+        {
+            auto result = isearch( std::begin(A), std::end(A), i );
+            EXPECT_EQ( result, std::end(A) );
+        }
+    }
+
+    {
+        //=== Test #5
+        BEGIN_TEST(tm8, "EmptyRange", "Search for an element on an empty range.");
+        // DISABLE();
+        value_type A[]{ 1, 3, 5, 7, 9, 11 };
+
+        // Let us simulate an empty range here.
+        auto first = std::begin(A);
+        auto last = std::begin(A);
+        auto result = isearch( first, last, 10 );
+        EXPECT_EQ( result, last );
+    }
+
+    {
+        //=== Test #6
+        BEGIN_TEST(tm8, "SkewedDistribution", "Keys grow exponentially, so the probe budget runs out and binary search takes over." );
+        // DISABLE();
+        std::vector< long > V;
+        for ( long v{1} ; v < ( 1L << 40 ) ; v *= 4 ) { V.push_back( v ); V.push_back( v + 1 ); }
+
+        for ( auto i{0u} ; i < V.size() ; ++i )
+        {
+            EXPECT_EQ( isearch( V.begin(), V.end(), V[i], 2 ), V.begin() + i );
+            EXPECT_EQ( isearch( V.begin(), V.end(), V[i] * 3, 2 ), V.end() );
+        }
+    }
+
+    {
+        //=== Test #7
+        BEGIN_TEST(tm8, "LargeKeys", "64-bit keys past 2^53, which the interpolation sees as equal doubles." );
+        // DISABLE();
+        const std::int64_t base{ std::int64_t{1} << 60 };
+        std::vector< std::int64_t > V{ base, base + 1, base + 2, base + 4, base + 5 };
+
+        for ( auto i{0u} ; i < V.size() ; ++i )
+            EXPECT_EQ( isearch( V.begin(), V.end(), V[i] ), V.begin() + i );
+        EXPECT_EQ( isearch( V.begin(), V.end(), base + 3 ), V.end() );
+        EXPECT_EQ( isearch( V.begin(), V.end(), base - 1 ), V.end() );
+        EXPECT_EQ( isearch( V.begin(), V.end(), base + 6 ), V.end() );
+    }
+
+    tm8.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the exponential search.
+    TestManager tm9{ "Exponential Search Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm9, "BasicSearch", "Search for all n elements present in the array." );
+        // DISABLE();
+        value_type A[]{ 1, 2, 3, 4, 5, 6, 7 };
+
+        // Looking for each element from A in A.
+        for ( const auto & e : A )
+        {
+            auto result = esearch( std::begin(A), std::end(A), e );
+            EXPECT_EQ( *result, e );
+            EXPECT_EQ( e-1, std::distance(std::begin(A), result ) );
+        }
+    }
+    {
+        //=== Test #2
+        BEGIN_TEST(tm9, "NotPresentToLeft", "Search for an element that is not present, whose value is smaller than the first element of the array." );
+        // DISABLE();
+        value_type A[]{ 1, 2, 3, 4, 5, 6, 7 };
+
+        auto target{-4};
+        auto result = esearch( std::begin(A), std::end(A), target );
+        EXPECT_EQ( result, std::end(A) );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm9, "NotPresentToRight", "Search for an element that is not present, whose value is greater than the last element of the array." );
+        // DISABLE();
+        value_type A[]{ 1, 2, 3, 4, 5, 6, 7 };
+
+        auto target{10};
+        auto result = esearch( std::begin(A), std::end(A), target );
+        EXPECT_EQ( result, std::end(A) );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm9, "NotPresentInBetween", "Search for an element that is not present, whose value is between the first and the last elements of the array." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5, 7, 9, 11 };
+
+        for ( auto i{2} ; i < 11 ; i+=2 )
+        {
+            auto result = esearch( std::begin(A), std::end(A), i );
+            EXPECT_EQ( result, std::end(A) );
+        }
+    }
+
+    {
+        //=== Test #5
+        BEGIN_TEST(tm9, "EmptyRange", "Search for an element on an empty range.");
+        // DISABLE();
+        value_type A[]{ 1, 3, 5, 7, 9, 11 };
+
+        // Let us simulate an empty range here.
+        auto first = std::begin(A);
+        auto last = std::begin(A);
+        auto result = esearch( first, last, 10 );
+        EXPECT_EQ( result, last );
+    }
+
+    {
+        //=== Test #6
+        BEGIN_TEST(tm9, "EveryPositionAndGap", "Search every element and every gap of ranges of growing size." );
+        // DISABLE();
+        for ( auto n{1} ; n <= 40 ; ++n )
+        {
+            std::vector< value_type > V( n );
+            for ( auto i{0} ; i < n ; ++i ) V[i] = 2 * i;
+            for ( auto i{0} ; i < n ; ++i )
+            {
+                EXPECT_EQ( esearch( V.begin(), V.end(), 2 * i ), V.begin() + i );
+                EXPECT_EQ( esearch( V.begin(), V.end(), 2 * i + 1 ), V.end() );
+            }
+        }
+    }
+
+    tm9.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the compile-time size search.
+    TestManager tm10{ "Fixed Size Search Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm10, "BasicSearch", "Search for all n elements present in the array." );
+        // DISABLE();
+        value_type A[]{ 1, 2, 3, 4, 5, 6, 7 };
+
+        for ( const auto & e : A )
+            EXPECT_EQ( bsearch_fixed( A, e ), std::size_t( e-1 ) );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm10, "NotPresent", "Search for elements not present: left, right and in between." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5, 7, 9, 11 };
+
+        EXPECT_EQ( bsearch_fixed( A, -4 ), std::size_t( 6 ) );
+        EXPECT_EQ( bsearch_fixed( A, 12 ), std::size_t( 6 ) );
+        for ( auto i{2} ; i < 11 ; i+=2 )
+            EXPECT_EQ( bsearch_fixed( A, i ), std::size_t( 6 ) );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm10, "StdArray", "Search every position and gap of std::array tables of several sizes." );
+        // DISABLE();
+        std::array< value_type, 1 > A1{ { 0 } };
+        std::array< value_type, 16 > A16;
+        std::array< value_type, 1024 > A1024;
+        for ( auto i{0u} ; i < A16.size() ; ++i ) A16[i] = 2 * i;
+        for ( auto i{0u} ; i < A1024.size() ; ++i ) A1024[i] = 2 * i;
+
+        EXPECT_EQ( bsearch_fixed( A1, 0 ), std::size_t( 0 ) );
+        EXPECT_EQ( bsearch_fixed( A1, 1 ), std::size_t( 1 ) );
+        for ( auto i{0u} ; i < A16.size() ; ++i )
+        {
+            EXPECT_EQ( bsearch_fixed( A16, value_type( 2 * i ) ), i );
+            EXPECT_EQ( bsearch_fixed( A16, value_type( 2 * i + 1 ) ), A16.size() );
+        }
+        for ( auto i{0u} ; i < A1024.size() ; ++i )
+        {
+            EXPECT_EQ( bsearch_fixed( A1024, value_type( 2 * i ) ), i );
+            EXPECT_EQ( bsearch_fixed( A1024, value_type( 2 * i + 1 ) ), A1024.size() );
+        }
+    }
+
+    tm10.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the equal range and count queries.
+    TestManager tm11{ "Equal Range Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm11, "EqualRange", "Equal range agrees with the standard library, present and missing targets." );
+        // DISABLE();
+        value_type A[]{ 1, 1, 1, 3, 3, 5, 5, 5, 7, 7, 7, 9, 9 };
+
+        for ( auto value{0} ; value <= 10 ; ++value )
+        {
+            auto range = sa::equal_range( std::begin(A), std::end(A), value );
+            auto expected = std::equal_range( std::begin(A), std::end(A), value );
+            EXPECT_EQ( range.first, expected.first );
+            EXPECT_EQ( range.second, expected.second );
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm11, "EqualRangeEmpty", "Equal range on an empty range." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5 };
+
+        auto range = sa::equal_range( std::begin(A), std::begin(A), 3 );
+        EXPECT_EQ( range.first, std::begin(A) );
+        EXPECT_EQ( range.second, std::begin(A) );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm11, "CountSorted", "Count every value of a range with repetitions, through class iterators." );
+        // DISABLE();
+        std::vector< value_type > V{ 1, 1, 1, 1, 1, 1, 1, 1, 2, 4, 4, 4, 4 };
+
+        EXPECT_EQ( count_sorted( V.begin(), V.end(), 0 ), 0u );
+        EXPECT_EQ( count_sorted( V.begin(), V.end(), 1 ), 8u );
+        EXPECT_EQ( count_sorted( V.begin(), V.end(), 2 ), 1u );
+        EXPECT_EQ( count_sorted( V.begin(), V.end(), 3 ), 0u );
+        EXPECT_EQ( count_sorted( V.begin(), V.end(), 4 ), 4u );
+        EXPECT_EQ( count_sorted( V.begin(), V.end(), 5 ), 0u );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm11, "CountSortedMany", "Histogram of sorted and unsorted keys." );
+        // DISABLE();
+        value_type A[]{ 1, 1, 1, 3, 3, 5, 5, 5, 7, 7, 7, 9, 9 };
+        value_type sorted_keys[]{ 0, 1, 2, 3, 5, 5, 9, 10 };
+        value_type unsorted_keys[]{ 9, 3, 0, 7, 1, 1 };
+        std::vector< std::size_t > counts;
+
+        count_sorted_many( std::begin(A), std::end(A), std::begin(sorted_keys), std::end(sorted_keys),
+                           std::back_inserter(counts) );
+        std::vector< std::size_t > expected{ 0, 3, 0, 2, 3, 3, 2, 0 };
+        EXPECT_EQ( counts, expected );
+
+        counts.clear();
+        count_sorted_many( std::begin(A), std::end(A), std::begin(unsorted_keys), std::end(unsorted_keys),
+                           std::back_inserter(counts) );
+        expected = { 2, 2, 0, 3, 3, 3 };
+        EXPECT_EQ( counts, expected );
+    }
+
+    tm11.summary();
+    std::cout << std::endl;
+
     return EXIT_SUCCESS;
 }
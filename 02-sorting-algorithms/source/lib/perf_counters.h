@@ -0,0 +1,132 @@
+/**
+ * Hardware performance counters around a block of code, through Linux perf_event_open.
+ *
+ * Cycles, instructions, branch misses and cache misses of the calling thread are
+ * counted in user space, as one event group so that they are scheduled together.
+ * Counters the kernel or the CPU do not provide (no PMU in a virtual machine,
+ * perf_event_paranoid too high, another OS) are reported as unavailable instead of
+ * failing: a counter that could not be opened reads as -1.
+ * Only the calling thread is counted: work handed to other threads is not seen.
+ * When the CPU has fewer counters than requested, the kernel multiplexes them and
+ * each value is scaled by the share of the time its counter actually ran.
+ * @date July 5th, 2021
+ * @file perf_counters.h
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>        // std::array
+#include <cerrno>       // errno
+#include <cstdint>      // std::int64_t
+#include <cstring>      // std::memset, std::strerror
+#include <string>       // std::string
+
+#if defined(__linux__)
+#define SA_PERF_EVENTS 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define SA_PERF_EVENTS 0
+#endif
+
+namespace sa { // sa = sorting algorithms
+
+    /// Counter values read by perf_counters::stop().
+    struct perf_sample {
+        /// The counters, in the order of perf_sample::names().
+        enum counter { CYCLES, INSTRUCTIONS, BRANCH_MISSES, CACHE_MISSES, N_COUNTERS };
+        std::array<std::int64_t, N_COUNTERS> value{{-1, -1, -1, -1}}; //!< -1 where the counter is unavailable.
+
+        /// Names of the counters, usable as column names.
+        static const std::array<const char *, N_COUNTERS> & names(void){
+            static const std::array<const char *, N_COUNTERS> n{{"CYCLES", "INSTRUCTIONS", "BRANCH_MISSES", "CACHE_MISSES"}};
+            return n;
+        }
+    };
+
+    /// The counters of perf_sample, for the calling thread, started and stopped around the code to measure.
+    class perf_counters {
+        public:
+            /// Opens the counters; check available() before relying on them.
+            perf_counters(){
+                m_fd.fill(-1);
+#if SA_PERF_EVENTS
+                const std::uint64_t config[perf_sample::N_COUNTERS] = {
+                    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                    PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES
+                };
+                for(int c = 0; c < perf_sample::N_COUNTERS; c++) {
+                    perf_event_attr attr;
+                    std::memset(&attr, 0, sizeof(attr));
+                    attr.size = sizeof(attr);
+                    attr.type = PERF_TYPE_HARDWARE;
+                    attr.config = config[c];
+                    attr.disabled = m_leader < 0;  // the group is enabled through its leader.
+                    attr.exclude_kernel = 1;
+                    attr.exclude_hv = 1;
+                    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, m_leader, 0);
+                    if(fd < 0) {
+                        if(m_error.empty()) m_error = std::string(perf_sample::names()[c]) + ": " + std::strerror(errno);
+                        continue;
+                    }
+                    m_fd[c] = static_cast<int>(fd);
+                    if(m_leader < 0) m_leader = m_fd[c];
+                }
+#else
+                m_error = "perf_event_open is only available on Linux";
+#endif
+            }
+
+            ~perf_counters(){
+#if SA_PERF_EVENTS
+                for(int fd : m_fd) if(fd >= 0) close(fd);
+#endif
+            }
+
+            perf_counters(const perf_counters &) = delete;
+            perf_counters & operator=(const perf_counters &) = delete;
+
+            /// Whether at least one counter could be opened.
+            bool available(void) const { return m_leader >= 0; }
+
+            /// Why the first counter that failed to open did, empty if all of them opened.
+            const std::string & error(void) const { return m_error; }
+
+            /// Resets and starts the counters.
+            void start(void){
+#if SA_PERF_EVENTS
+                if(m_leader < 0) return;
+                ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+            }
+
+            /// Stops the counters and returns what they counted since start(), scaled up if they were multiplexed.
+            perf_sample stop(void){
+                perf_sample sample;
+#if SA_PERF_EVENTS
+                if(m_leader < 0) return sample;
+                ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+                for(int c = 0; c < perf_sample::N_COUNTERS; c++) {
+                    std::uint64_t data[3];  // value, time enabled, time running.
+                    if(m_fd[c] < 0 || read(m_fd[c], data, sizeof(data)) != sizeof(data)) continue;
+                    if(data[2] == 0) continue;  // never scheduled: nothing was counted.
+                    double scale = data[2] < data[1] ? static_cast<double>(data[1]) / data[2] : 1.0;
+                    sample.value[c] = static_cast<std::int64_t>(data[0] * scale);
+                }
+#endif
+                return sample;
+            }
+
+        private:
+            std::array<int, perf_sample::N_COUNTERS> m_fd;  //!< One file descriptor per counter, -1 if unavailable.
+            int m_leader{-1};                                //!< Group leader: the first counter opened.
+            std::string m_error;                             //!< First failure to open a counter.
+    };
+}
+
+#endif // PERF_COUNTERS_H
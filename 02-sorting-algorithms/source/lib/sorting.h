@@ -31,9 +31,17 @@ using std::string;
 using std::to_string;
 #include <bits/stdc++.h>
 #include <type_traits>
+#include <cstdint>
+#include <cstring>
 #include <utility>
+#include <numeric>
+#include <atomic>
+#include <limits>
+#include <new>
 #include <iomanip>
 #include <iostream>
+#include "thread_pool.h"
+#include "sorting_networks.h"
 namespace sa { // sa = sorting algorithms
     /// Prints out the range to a string and returns it to the client.
     template <typename FwrdIt>
@@ -46,17 +54,84 @@ namespace sa { // sa = sorting algorithms
         return oss.str();
     }
     //{{{ INSERTION SORT
-    /// Implementation of the Insertion Sort algorithm.
+    /*!
+     * Implementation of the Insertion Sort algorithm.
+     * The element being inserted is moved out once, the greater ones are shifted one
+     * position to the right, and it is moved into the hole left at its place.
+     */
     template< typename RandomIt, typename Compare >
     void insertion(RandomIt first, RandomIt last, Compare cmp){
         for(auto i = 1; i < (last-first); i++){
-            for(auto j=i; j > 0 && cmp(*(first+j),*(first+j-1)); j--)
-                std::swap(*(first+j),*(first+j-1));
+            if(!cmp(*(first+i),*(first+i-1))) continue; // already in place
+            auto value = std::move(*(first+i));
+            auto j = i;
+            for(; j > 0 && cmp(value,*(first+j-1)); j--)
+                *(first+j) = std::move(*(first+j-1));
+            *(first+j) = std::move(value);
         }
         return;
     }
     //}}} INSERTION SORT
 
+    //{{{ SMALL SORT
+    namespace detail {
+        /// Whether Compare is the natural `<` order on T.
+        template< typename Compare, typename T >
+        struct is_natural_less : std::integral_constant<bool,
+            std::is_same<Compare, std::less<T>>::value || std::is_same<Compare, std::less<>>::value> {};
+
+        /// Whether RandomIt walks over contiguous storage: a pointer or a std::vector iterator.
+        template< typename RandomIt >
+        struct is_contiguous_iterator : std::integral_constant<bool, std::is_pointer<RandomIt>::value
+            || std::is_same<RandomIt, typename std::vector<typename std::iterator_traits<RandomIt>::value_type>::iterator>::value> {};
+
+        /*!
+         * Whether small slices of [RandomIt] sorted by Compare can go to network_sort().
+         * When the caller needs stability only integers qualify: network_sort() may swap
+         * -0.0 and +0.0, which compare equal but can be told apart.
+         */
+        template< typename RandomIt, typename Compare, bool Stable >
+        struct use_network {
+            using T = typename std::iterator_traits<RandomIt>::value_type;
+            static constexpr bool value = is_network_sortable<T>::value && is_contiguous_iterator<RandomIt>::value
+                && is_natural_less<Compare, T>::value && (!Stable || std::is_integral<T>::value);
+        };
+
+        template< typename RandomIt, typename Compare >
+        void small_sort(RandomIt first, RandomIt last, Compare cmp, std::true_type){
+            std::ptrdiff_t n = last - first;
+            if(n < 2) return;
+            if(n <= static_cast<std::ptrdiff_t>(NETWORK_MAX)) sa::network_sort(&*first, n);
+            else sa::insertion(first, last, cmp);
+        }
+
+        template< typename RandomIt, typename Compare >
+        void small_sort(RandomIt first, RandomIt last, Compare cmp, std::false_type){
+            sa::insertion(first, last, cmp);
+        }
+
+        /// Stable flavour of sa::small_sort(), the base case of the merge sorts.
+        template< typename RandomIt, typename Compare >
+        void stable_small_sort(RandomIt first, RandomIt last, Compare cmp){
+            small_sort(first, last, cmp, std::integral_constant<bool, use_network<RandomIt, Compare, true>::value>{});
+        }
+    }
+
+    /*!
+     * Base case kernel of the recursive sorts: sorts a small slice with a SIMD sorting
+     * network (see sorting_networks.h) when the elements are `int32_t` or `float` in
+     * contiguous memory and `cmp` is `std::less`, or with insertion sort otherwise.
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void small_sort(RandomIt first, RandomIt last, Compare cmp){
+        detail::small_sort(first, last, cmp, std::integral_constant<bool, detail::use_network<RandomIt, Compare, false>::value>{});
+    }
+    //}}} SMALL SORT
+
     //{{{ SELECTION SORT
     template< typename RandomIt, typename Compare >
     void selection(RandomIt first, RandomIt last, Compare cmp){
@@ -68,7 +143,7 @@ namespace sa { // sa = sorting algorithms
                     min_index = j;
             }
             if(min_index != i){
-                std::swap(*(first+i),*(first+min_index));   
+                std::iter_swap(first+i, first+min_index);   
             }
         }
         return;
@@ -76,18 +151,28 @@ namespace sa { // sa = sorting algorithms
     //}}} SELECTION SORT
 
     //{{{ BUBBLE SORT
+    /*
+    Instead of swapping it with every smaller neighbour, an element that bubbles up
+    is moved out once and carried: the smaller elements it passes are shifted one
+    position to the left. Each pass stops where the previous one made its last move.
+    */
     template< typename RandomIt, typename Compare >
     void bubble(RandomIt first, RandomIt last, Compare cmp){
-        int temp, sz = std::distance(first, last);
-        for(int i = sz; i > 1; i++){
-            temp = 0;
-            for(int j=1; j < sz; j++){
-                if(cmp(*(first+j),*(first+j-1))){
-                    std::swap(*(first+j),*(first+j-1));
-                    temp = j;
-                }
-            }  
-            i = temp;
+        int sz = std::distance(first, last);
+        for(int bound = sz; bound > 1; ){
+            int last_move = 0;
+            int j = 1;
+            while(j < bound){
+                if(!cmp(*(first+j),*(first+j-1))){ j++; continue; }
+                auto carried = std::move(*(first+j-1));
+                do{
+                    *(first+j-1) = std::move(*(first+j));
+                    j++;
+                }while(j < bound && cmp(*(first+j),carried));
+                *(first+j-1) = std::move(carried);
+                last_move = j-1;
+            }
+            bound = last_move;
         }
         return;  
     }
@@ -96,31 +181,26 @@ namespace sa { // sa = sorting algorithms
     //{{{ SHELL SORT
     /*
     Knuth sequence was used.
+    Each pass is an insertion sort among the elements `gap` positions apart: the
+    element being inserted is moved out once and the greater ones are shifted.
     */
     template< typename RandomIt, typename Compare >
     void shell(RandomIt first, RandomIt last, Compare cmp){
+        int sz = last-first;
         int gap;
         //Calculate the first gap, based on Knuth sequence
-        for(gap = 1; gap < (last-first); gap = 3*gap+1); 
-        while (gap > 0){
-            //Descrease the gap
-            gap = (gap-1)/3;
-            //Pass by elements to swap then if necessary
-            for(size_t i =0 ; first+gap+i < last ; i++){
-                if(cmp(*(first+gap+i),*(first+i))){
-                    std::swap(*(first+gap+i),*(first+i));
-                    /*In case some element was sawpped, it will 
-                    try swap the elements before, maintaining the gap
-                    */
-                    for(int j = i-gap; j >= 0; j-= gap){   
-                        if(cmp(*(first+gap+j),*(first+j))){
-                            std::swap(*(first+gap+j),*(first+j));
-                        }         
-                    }
-
-                }
+        for(gap = 1; gap < sz/3; gap = 3*gap+1);
+        for(; gap > 0; gap = (gap-1)/3){
+            for(int i = gap; i < sz; i++){
+                if(!cmp(*(first+i),*(first+i-gap))) continue; // already in place
+                auto value = std::move(*(first+i));
+                int j = i;
+                do{
+                    *(first+j) = std::move(*(first+j-gap));
+                    j -= gap;
+                }while(j >= gap && cmp(value,*(first+j-gap)));
+                *(first+j) = std::move(value);
             }
-            
         }
     }
     //}}} SHELL SORT
@@ -141,39 +221,45 @@ namespace sa { // sa = sorting algorithms
      * @param r_last Past the last element in the right sub-range.
      * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
      */
-    template< typename RandomIt, typename Compare >
+    template< typename InputIt, typename OutputIt, typename Compare >
     // void merge(RandomIt first, RandomIt last, Compare cmp) {
-    void merge( RandomIt l_first, RandomIt l_last, // [l_first; l_last)
-            RandomIt r_first, RandomIt r_last, // [r_first; r_last)
-            RandomIt first, Compare cmp) {
+    void merge( InputIt l_first, InputIt l_last, // [l_first; l_last)
+            InputIt r_first, InputIt r_last, // [r_first; r_last)
+            OutputIt first, Compare cmp) {
         
+        // elements are moved, not copied: the sub-ranges are scratch space.
         while(l_first != l_last && r_first != r_last) {
-            if(cmp(*l_first, *r_first)) {
-                *first = *l_first;
+            if(cmp(*r_first, *l_first)) { // ties take the left one, so the sort is stable
+                *first = std::move(*r_first);
                 first++;
-                l_first++;
+                r_first++;
             } else {
-                *first = *r_first;
+                *first = std::move(*l_first);
                 first++;
-                r_first++;
+                l_first++;
             }
         }
 
         while(l_first != l_last) {
-            *first = *l_first;
+            *first = std::move(*l_first);
             first++;
             l_first++;
         }
     
         while(r_first != r_last) {
-            *first = *r_first;
+            *first = std::move(*r_first);
             first++;
             r_first++;
         }
     }
 
+    /*!
+     * Merge sort, on two buffers allocated at every level.
+     * @param small_cutoff Slices of up to this many elements go to the stable flavour of
+     * small_sort() (a sorting network, when one applies); 0 recurses down to single elements.
+     */
     template< typename RandomIt, typename Compare >
-    void mergesort(RandomIt first, RandomIt last, Compare cmp) {
+    void mergesort(RandomIt first, RandomIt last, Compare cmp, std::ptrdiff_t small_cutoff = 0) {
         
         using DataType = typename std::remove_reference<decltype(*std::declval<RandomIt>())>::type;
 
@@ -181,6 +267,10 @@ namespace sa { // sa = sorting algorithms
         
         // basis step: 0 or 1 element
         if(sz < 2) return;
+        if(sz <= small_cutoff) {
+            detail::stable_small_sort(first, last, cmp);
+            return;
+        }
 
         // find out the size of the first half
         int n = sz/2;
@@ -193,13 +283,13 @@ namespace sa { // sa = sorting algorithms
         DataType *L = new DataType[L_sz]; 
         DataType *R = new DataType[R_sz];
 
-        // copy elements from each half of A, respectively into L and R
-        std::copy(first, first + n, L);
-        std::copy(first + n, last, R);
+        // move elements from each half of A, respectively into L and R
+        std::move(first, first + n, L);
+        std::move(first + n, last, R);
 
-        mergesort(L, L + L_sz, cmp);
-        mergesort(R, R + R_sz, cmp); //  L + L_sz (R) belongs to the second half
-        merge(L, L + L_sz, // [l_first; l_last)
+        mergesort(L, L + L_sz, cmp, small_cutoff);
+        mergesort(R, R + R_sz, cmp, small_cutoff); //  L + L_sz (R) belongs to the second half
+        sa::merge(L, L + L_sz, // [l_first; l_last)
             R, R + R_sz, // [r_first; r_last)
             first, cmp);
         
@@ -249,26 +339,906 @@ namespace sa { // sa = sorting algorithms
         while(fast != last) {
             if(cmp(*fast, *pivot)) { 
                 slow++;
-                std::swap(*slow, *fast);
+                std::iter_swap(slow, fast);
             }
             fast++;
         }
         // We need a final swap, so that the pivot end up in its final position
         // in the sorted array.
-        std::swap(*(slow + 1), *(last - 1));
+        std::iter_swap(slow + 1, last - 1);
         return slow + 1;
     }
-    /// Quick sort implementation.
+
+    namespace detail {
+        /// Elements per block of block_partition(); offsets within a block fit in a byte.
+        constexpr std::ptrdiff_t PARTITION_BLOCK = 64;
+    }
+
+    /*!
+     * Block partition (BlockQuicksort): same contract and pivot as partition(), but
+     * without a data-dependent branch per element.
+     *
+     * A block of elements is scanned from each end of the range, and the offsets of
+     * the misplaced ones (greater or equal on the left, less on the right) are written
+     * unconditionally to a buffer, advancing its end by the result of the comparison.
+     * The misplaced elements are then swapped in pairs. The last (less than two)
+     * blocks are partitioned by the plain loop.
+     *
+     * @param first The first element in the range we want to reorder.
+     * @param last Past the last element in the range we want to reorder.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return An iterator to the new pivot location within the range.
+     */
+    template<class RandomIt, class Compare>
+    RandomIt block_partition(RandomIt first, RandomIt last, Compare cmp){
+        using detail::PARTITION_BLOCK;
+        // median-of-three pivot, moved to the last position, as in partition().
+        RandomIt mid = first + std::distance(first, last)/2;
+        RandomIt last_value = last - 1;
+        if(cmp(*mid, *first)) std::iter_swap(mid, first);
+        if(cmp(*last_value, *first)) std::iter_swap(first, last_value);
+        if(cmp(*mid, *last_value)) std::iter_swap(mid, last_value);
+        const auto &pivot = *last_value;
+
+        // [first;l) is less than the pivot, [r;last-1) is not.
+        RandomIt l = first, r = last_value;
+        unsigned char offsets_l[PARTITION_BLOCK], offsets_r[PARTITION_BLOCK];
+        int start_l = 0, start_r = 0, num_l = 0, num_r = 0;
+        while(r - l >= 2*PARTITION_BLOCK) {
+            if(num_l == 0) {
+                start_l = 0;
+                for(int i = 0; i < PARTITION_BLOCK; i++) {
+                    offsets_l[num_l] = static_cast<unsigned char>(i);
+                    num_l += !cmp(*(l + i), pivot);
+                }
+            }
+            if(num_r == 0) {
+                start_r = 0;
+                for(int i = 0; i < PARTITION_BLOCK; i++) {
+                    offsets_r[num_r] = static_cast<unsigned char>(i);
+                    num_r += cmp(*(r - 1 - i), pivot);
+                }
+            }
+            int num = std::min(num_l, num_r);
+            for(int k = 0; k < num; k++)
+                std::iter_swap(l + offsets_l[start_l + k], r - 1 - offsets_r[start_r + k]);
+            num_l -= num; num_r -= num;
+            start_l += num; start_r += num;
+            // a block is done once all its misplaced elements were swapped.
+            if(num_l == 0) l += PARTITION_BLOCK;
+            if(num_r == 0) r -= PARTITION_BLOCK;
+        }
+
+        // what is left, including a block that was only partly swapped, is rescanned.
+        for(RandomIt fast = l; fast != r; fast++) {
+            if(cmp(*fast, pivot)) {
+                std::iter_swap(l, fast);
+                l++;
+            }
+        }
+        std::iter_swap(l, last_value);
+        return l;
+    }
+
+    /// Partition schemes of quick().
+    enum class partition_scheme {
+        lomuto, //!< partition(): one pass, a branch per element.
+        block   //!< block_partition(): branchless, blocks of offsets.
+    };
+
+    /*!
+     * Quick sort implementation.
+     * @param small_cutoff Slices of up to this many elements go to small_sort() (a sorting
+     * network, when one applies); 0 recurses down to single elements.
+     */
     template<typename RandomIt, typename Compare>
-    void quick(RandomIt first,RandomIt last,Compare comp){
+    void quick(RandomIt first,RandomIt last,Compare comp, partition_scheme scheme = partition_scheme::lomuto,
+               std::ptrdiff_t small_cutoff = 0){
+        if(last - first > 1 && last - first <= small_cutoff) {
+            sa::small_sort(first, last, comp);
+            return;
+        }
         if(first < last) {
-            RandomIt p = sa::partition(first, last, comp);
-            quick(first, p, comp); 
-            quick(p + 1, last, comp);
+            RandomIt p = scheme == partition_scheme::block ? sa::block_partition(first, last, comp)
+                                                           : sa::partition(first, last, comp);
+            quick(first, p, comp, scheme, small_cutoff); 
+            quick(p + 1, last, comp, scheme, small_cutoff);
         }
     }
     //}}} QUICK SORT 
 
+    //{{{ INTROSORT
+    namespace detail {
+        /// Slices with up to this many elements are left for insertion sort.
+        constexpr std::ptrdiff_t INSERTION_CUTOFF = 16;
+        /// Slices with more than this many elements pick the pivot with Tukey's ninther.
+        constexpr std::ptrdiff_t NINTHER_THRESHOLD = 128;
+
+        /// Returns the iterator to the median of *a, *b and *c.
+        template< typename RandomIt, typename Compare >
+        RandomIt median3(RandomIt a, RandomIt b, RandomIt c, Compare cmp){
+            if(cmp(*a, *b)) {
+                if(cmp(*b, *c)) return b;       // a < b < c
+                return cmp(*a, *c) ? c : a;     // a < b, c <= b
+            }
+            if(cmp(*a, *c)) return a;           // b <= a < c
+            return cmp(*b, *c) ? c : b;         // b <= a, c <= a
+        }
+
+        /// Moves the pivot of [first;last) to *first: median-of-three, or ninther for large slices.
+        template< typename RandomIt, typename Compare >
+        void choose_pivot(RandomIt first, RandomIt last, Compare cmp){
+            auto n = last - first;
+            RandomIt mid = first + n/2;
+            RandomIt pivot;
+            if(n > NINTHER_THRESHOLD) {
+                auto s = n/8;
+                pivot = median3(median3(first, first + s, first + 2*s, cmp),
+                                median3(mid - s, mid, mid + s, cmp),
+                                median3(last - 1 - 2*s, last - 1 - s, last - 1, cmp), cmp);
+            }
+            else pivot = median3(first, mid, last - 1, cmp);
+            std::iter_swap(first, pivot);
+        }
+
+        /*!
+         * Hoare partition of [first;last) around the pivot stored at *first.
+         *
+         * Both scans stop on elements equal to the pivot, so runs of duplicate keys
+         * are split evenly between the two sides instead of piling up on one of them.
+         * @return An iterator to the final position of the pivot: everything before it
+         *   is not greater than the pivot, everything after it is not less.
+         */
+        template< typename RandomIt, typename Compare >
+        RandomIt hoare_partition(RandomIt first, RandomIt last, Compare cmp){
+            RandomIt lo = first + 1;
+            RandomIt hi = last - 1;
+            while(true) {
+                while(lo <= hi && cmp(*lo, *first)) ++lo;
+                while(lo <= hi && cmp(*first, *hi)) --hi;
+                if(lo >= hi) break;
+                std::iter_swap(lo++, hi--);
+            }
+            std::iter_swap(first, hi);
+            return hi;
+        }
+
+        /// Restores the max-heap property of the subtree rooted at index i of a heap with n elements.
+        template< typename RandomIt, typename Compare >
+        void sift_down(RandomIt first, std::ptrdiff_t i, std::ptrdiff_t n, Compare cmp){
+            // the root is moved out, and greater children move up into the hole it leaves.
+            auto value = std::move(*(first + i));
+            while(2*i + 1 < n) {
+                std::ptrdiff_t child = 2*i + 1;
+                if(child + 1 < n && cmp(*(first + child), *(first + child + 1))) child++;
+                if(!cmp(value, *(first + child))) break;
+                *(first + i) = std::move(*(first + child));
+                i = child;
+            }
+            *(first + i) = std::move(value);
+        }
+
+        /// Heap sort, the O(n log n) worst-case fallback of introsort.
+        template< typename RandomIt, typename Compare >
+        void heap_sort(RandomIt first, RandomIt last, Compare cmp){
+            std::ptrdiff_t n = last - first;
+            for(std::ptrdiff_t i = n/2 - 1; i >= 0; i--) sift_down(first, i, n, cmp);
+            for(std::ptrdiff_t end = n - 1; end > 0; end--) {
+                std::iter_swap(first, first + end);
+                sift_down(first, 0, end, cmp);
+            }
+        }
+
+        /// Introsort main loop: partitions until the slices are small or the depth budget runs out.
+        template< typename RandomIt, typename Compare >
+        void introsort_loop(RandomIt first, RandomIt last, int depth, Compare cmp){
+            while(last - first > INSERTION_CUTOFF) {
+                // too many bad pivots: this slice is degenerating, finish it with heap sort.
+                if(depth == 0) {
+                    heap_sort(first, last, cmp);
+                    return;
+                }
+                depth--;
+                choose_pivot(first, last, cmp);
+                RandomIt p = hoare_partition(first, last, cmp);
+                // recurse on the smaller side and loop on the larger one: O(log n) stack.
+                if(p - first < last - (p + 1)) {
+                    introsort_loop(first, p, depth, cmp);
+                    first = p + 1;
+                }
+                else {
+                    introsort_loop(p + 1, last, depth, cmp);
+                    last = p;
+                }
+            }
+            sa::small_sort(first, last, cmp);
+        }
+    }
+
+    /*!
+     * Introsort: quick sort hardened against its worst cases.
+     *
+     * - the pivot is the median of three elements, or Tukey's ninther (median of three
+     *   medians of three) for slices with more than 128 elements;
+     * - Hoare partitioning splits runs of equal keys evenly between both sides;
+     * - slices of up to 16 elements are left for insertion sort;
+     * - only the smaller side is sorted recursively, so the stack depth is O(log n);
+     * - after 2*log2(n) levels of partitioning, the slice is handed to heap sort, which
+     *   bounds the running time to O(n log n).
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void introsort(RandomIt first, RandomIt last, Compare cmp){
+        std::ptrdiff_t n = last - first;
+        int depth = 0;
+        while(n > 1) { n >>= 1; depth += 2; }
+        detail::introsort_loop(first, last, depth, cmp);
+    }
+    //}}} INTROSORT
+
+    //{{{ THREE-WAY QUICK SORT
+    /*!
+     * Three-way (Dutch national flag) partition of [first;last) around `pivot`.
+     *
+     * Reorders the range into three bands: elements **less** than the pivot, elements
+     * equivalent to it, and elements greater than it. Unlike sa::partition(), keys
+     * equal to the pivot are gathered in the middle band, so a sort built on this
+     * never has to look at them again.
+     *
+     * @param first The first element in the range we want to reorder.
+     * @param last Past the last element in the range we want to reorder.
+     * @param pivot The value to partition around (taken by copy, since the range is reordered).
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return The pair [lt;gt) that delimits the band of elements equivalent to the pivot.
+     */
+    template< typename RandomIt, typename T, typename Compare >
+    std::pair<RandomIt, RandomIt> partition3(RandomIt first, RandomIt last, T pivot, Compare cmp){
+        RandomIt lt = first;  // [first;lt) is less than the pivot
+        RandomIt i = first;   // [lt;i) is equivalent to the pivot
+        RandomIt gt = last;   // [gt;last) is greater than the pivot
+        while(i != gt) {
+            if(cmp(*i, pivot)) std::iter_swap(lt++, i++);
+            else if(cmp(pivot, *i)) std::iter_swap(i, --gt);
+            else ++i;
+        }
+        return { lt, gt };
+    }
+
+    /*!
+     * Quick sort on top of partition3(), for inputs with many duplicate keys.
+     *
+     * Each partition step removes the whole band of keys equal to the pivot, so a
+     * range with k distinct keys is sorted after at most k levels of partitioning
+     * no matter how many copies of each key it holds. The pivot is chosen as in
+     * introsort (median-of-three or ninther), the smaller side is sorted recursively
+     * and small slices are left for insertion sort.
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void quick3(RandomIt first, RandomIt last, Compare cmp){
+        while(last - first > detail::INSERTION_CUTOFF) {
+            detail::choose_pivot(first, last, cmp);
+            auto band = sa::partition3(first, last, *first, cmp);
+            if(band.first - first < last - band.second) {
+                quick3(first, band.first, cmp);
+                first = band.second;
+            }
+            else {
+                quick3(band.second, last, cmp);
+                last = band.first;
+            }
+        }
+        sa::small_sort(first, last, cmp);
+    }
+    //}}} THREE-WAY QUICK SORT
+
+    //{{{ HEAP SORT AND SELECTION
+    /*!
+     * Heap sort: builds a max-heap over the range and repeatedly moves its top to the end.
+     * O(n log n) in the worst case and in place, but not stable.
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void heapsort(RandomIt first, RandomIt last, Compare cmp){
+        detail::heap_sort(first, last, cmp);
+    }
+
+    /*!
+     * Rearranges the range so that [first;middle) holds its `middle - first` smallest
+     * elements in sorted order; the order of the rest is unspecified.
+     *
+     * A max-heap of the k = middle - first candidates is kept at the front: every other
+     * element that is less than the heap top replaces it. Runs in O(n log k).
+     *
+     * @param first The first element in the range.
+     * @param middle Past the last element that has to end up sorted.
+     * @param last Past the last element in the range.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare cmp){
+        std::ptrdiff_t k = middle - first;
+        if(k == 0) return;
+        for(std::ptrdiff_t i = k/2 - 1; i >= 0; i--) detail::sift_down(first, i, k, cmp);
+        for(RandomIt it = middle; it != last; ++it) {
+            if(cmp(*it, *first)) {
+                std::iter_swap(it, first);
+                detail::sift_down(first, 0, k, cmp);
+            }
+        }
+        for(std::ptrdiff_t end = k - 1; end > 0; end--) {
+            std::iter_swap(first, first + end);
+            detail::sift_down(first, 0, end, cmp);
+        }
+    }
+
+    namespace detail {
+        template< typename RandomIt, typename Compare >
+        void introselect(RandomIt first, RandomIt nth, RandomIt last, int depth, Compare cmp);
+
+        /*!
+         * Moves to *first a pivot that is guaranteed to have at least ~30% of the range
+         * on each side: the median of the medians of groups of 5 elements.
+         */
+        template< typename RandomIt, typename Compare >
+        void median_of_medians(RandomIt first, RandomIt last, Compare cmp){
+            std::ptrdiff_t n = last - first;
+            std::ptrdiff_t groups = 0;
+            for(std::ptrdiff_t g = 0; g < n; g += 5) {
+                RandomIt g_last = first + std::min(g + 5, n);
+                sa::insertion(first + g, g_last, cmp);
+                std::iter_swap(first + groups++, first + g + (g_last - (first + g))/2);
+            }
+            // the medians now sit at [first;first+groups): select their median, without randomness.
+            introselect(first, first + groups/2, first + groups, 0, cmp);
+            std::iter_swap(first, first + groups/2);
+        }
+
+        /*!
+         * Introselect: quickselect with the introsort pivot, falling back to median of
+         * medians pivots once `depth` partitions have gone by, which keeps it O(n).
+         */
+        template< typename RandomIt, typename Compare >
+        void introselect(RandomIt first, RandomIt nth, RandomIt last, int depth, Compare cmp){
+            while(last - first > INSERTION_CUTOFF) {
+                if(depth > 0) {
+                    depth--;
+                    choose_pivot(first, last, cmp);
+                }
+                else median_of_medians(first, last, cmp);
+                RandomIt p = hoare_partition(first, last, cmp);
+                if(p == nth) return;
+                if(nth < p) last = p;
+                else first = p + 1;
+            }
+            sa::insertion(first, last, cmp);
+        }
+    }
+
+    /*!
+     * Rearranges the range so that *nth is the element that would be there if the whole
+     * range were sorted, everything before it is not greater and everything after it is
+     * not less than it. Linear time on average and in the worst case.
+     *
+     * @param first The first element in the range.
+     * @param nth The position whose element we want.
+     * @param last Past the last element in the range.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void nth_element(RandomIt first, RandomIt nth, RandomIt last, Compare cmp){
+        if(nth == last) return;
+        std::ptrdiff_t n = last - first;
+        int depth = 0;
+        while(n > 1) { n >>= 1; depth += 2; }
+        detail::introselect(first, nth, last, depth, cmp);
+    }
+    //}}} HEAP SORT AND SELECTION
+
+    //{{{ BUFFERED MERGE SORT
+    namespace detail {
+        /*!
+         * Stable merge of the sorted ranges [l_first;l_last) and [r_first;r_last) into `out`.
+         * On ties the element of the left range goes first.
+         */
+        template< typename InputIt, typename OutputIt, typename Compare >
+        void merge_into(InputIt l_first, InputIt l_last, InputIt r_first, InputIt r_last,
+                OutputIt out, Compare cmp){
+            while(l_first != l_last && r_first != r_last) {
+                if(cmp(*r_first, *l_first)) *out++ = std::move(*r_first++);
+                else *out++ = std::move(*l_first++);
+            }
+            out = std::move(l_first, l_last, out);
+            std::move(r_first, r_last, out);
+        }
+
+        /// Merges the sorted halves [src;src+mid) and [src+mid;src+n) into dst, or just moves them if already in order.
+        template< typename InIt, typename OutIt, typename Compare >
+        void merge_halves(InIt src, std::ptrdiff_t mid, std::ptrdiff_t n, OutIt dst, Compare cmp){
+            if(!cmp(*(src + mid), *(src + mid - 1))) std::move(src, src + n, dst);
+            else merge_into(src, src + mid, src + mid, src + n, dst, cmp);
+        }
+
+        /*!
+         * Sorts the n elements held by `a`, leaving the result in `b` if `into_b` is set
+         * or back in `a` otherwise; the other range is scratch space.
+         *
+         * The halves are sorted into the range the result does not go to, and merged
+         * from there, so the two ranges swap roles at every level and elements are
+         * only ever moved by a merge (or by a leaf that has to end up in `b`).
+         */
+        template< typename It1, typename It2, typename Compare >
+        void mergesort_pingpong(It1 a, It2 b, std::ptrdiff_t n, bool into_b, Compare cmp){
+            if(n <= INSERTION_CUTOFF) {
+                stable_small_sort(a, a + n, cmp);
+                if(into_b) std::move(a, a + n, b);
+                return;
+            }
+            std::ptrdiff_t mid = n/2;
+            mergesort_pingpong(a, b, mid, !into_b, cmp);
+            mergesort_pingpong(a + mid, b + mid, n - mid, !into_b, cmp);
+            if(into_b) merge_halves(a, mid, n, b, cmp);
+            else merge_halves(b, mid, n, a, cmp);
+        }
+    }
+
+    /*!
+     * Merge sort that works with a single caller-supplied scratch buffer.
+     *
+     * The range and the buffer take turns as source and destination of the merges,
+     * runs of up to 16 elements are sorted with insertion sort, and the merge step
+     * is skipped when the two halves are already in order. The sort is stable.
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param buffer The beginning of a scratch range of at least `last - first` elements; their values are overwritten.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename BufferIt, typename Compare >
+    void mergesort_buffered(RandomIt first, RandomIt last, BufferIt buffer, Compare cmp){
+        std::ptrdiff_t n = last - first;
+        if(n < 2) return;
+        detail::mergesort_pingpong(first, buffer, n, false, cmp);
+    }
+
+    /*!
+     * Merge sort that allocates one scratch buffer, of the size of the range, up front.
+     * @see mergesort_buffered(RandomIt, RandomIt, BufferIt, Compare)
+     */
+    template< typename RandomIt, typename Compare >
+    void mergesort_buffered(RandomIt first, RandomIt last, Compare cmp){
+        using DataType = typename std::iterator_traits<RandomIt>::value_type;
+        if(last - first < 2) return;
+        std::vector<DataType> buffer(last - first);
+        detail::mergesort_pingpong(first, buffer.begin(), last - first, false, cmp);
+    }
+    //}}} BUFFERED MERGE SORT
+
+    //{{{ TIMSORT
+    namespace detail {
+        /// Ranges shorter than this are sorted by binary insertion alone; runs are at least half of it long.
+        constexpr std::ptrdiff_t TIMSORT_MIN_MERGE = 64;
+        /// Initial number of consecutive wins of one run after which a merge switches to galloping.
+        constexpr std::ptrdiff_t TIMSORT_MIN_GALLOP = 7;
+
+        /// Minimum run length for n elements: in [32;64], so that n/min_run is a power of 2 or just below one.
+        inline std::ptrdiff_t timsort_min_run(std::ptrdiff_t n){
+            std::ptrdiff_t r = 0;
+            while(n >= TIMSORT_MIN_MERGE) { r |= n & 1; n >>= 1; }
+            return n + r;
+        }
+
+        /*!
+         * Length of the run that starts at `first`, made ascending.
+         * A run is either non-descending or **strictly** descending; the latter is reversed
+         * in place, which keeps the sort stable since it holds no equal elements.
+         */
+        template< typename RandomIt, typename Compare >
+        std::ptrdiff_t timsort_count_run(RandomIt first, RandomIt last, Compare cmp){
+            RandomIt it = first + 1;
+            if(it == last) return 1;
+            if(cmp(*it, *first)) {
+                while(it != last && cmp(*it, *(it - 1))) ++it;
+                std::reverse(first, it);
+            }
+            else while(it != last && !cmp(*it, *(it - 1))) ++it;
+            return it - first;
+        }
+
+        /// Stable binary insertion sort of [first;last), knowing that [first;sorted) is already sorted.
+        template< typename RandomIt, typename Compare >
+        void binary_insertion(RandomIt first, RandomIt sorted, RandomIt last, Compare cmp){
+            for(; sorted != last; ++sorted) {
+                auto value = std::move(*sorted);
+                RandomIt pos = std::upper_bound(first, sorted, value, cmp);
+                std::move_backward(pos, sorted, sorted + 1);
+                *pos = std::move(value);
+            }
+        }
+
+        /// lower_bound of `key` in [first;last), probing 1, 2, 4, ... elements from the front first.
+        template< typename It, typename T, typename Compare >
+        It gallop_lower(It first, It last, const T &key, Compare cmp){
+            std::ptrdiff_t n = last - first, ofs = 1;
+            while(ofs <= n && cmp(*(first + (ofs - 1)), key)) ofs *= 2;
+            return std::lower_bound(first + ofs/2, first + std::min(ofs - 1, n), key, cmp);
+        }
+
+        /// upper_bound of `key` in [first;last), probing 1, 2, 4, ... elements from the front first.
+        template< typename It, typename T, typename Compare >
+        It gallop_upper(It first, It last, const T &key, Compare cmp){
+            std::ptrdiff_t n = last - first, ofs = 1;
+            while(ofs <= n && !cmp(key, *(first + (ofs - 1)))) ofs *= 2;
+            return std::upper_bound(first + ofs/2, first + std::min(ofs - 1, n), key, cmp);
+        }
+
+        /// lower_bound of `key` in [first;last), probing 1, 2, 4, ... elements from the back first.
+        template< typename It, typename T, typename Compare >
+        It gallop_lower_back(It first, It last, const T &key, Compare cmp){
+            std::ptrdiff_t n = last - first, ofs = 1;
+            while(ofs <= n && !cmp(*(last - ofs), key)) ofs *= 2;
+            return std::lower_bound(ofs <= n ? last - ofs + 1 : first, last - ofs/2, key, cmp);
+        }
+
+        /// upper_bound of `key` in [first;last), probing 1, 2, 4, ... elements from the back first.
+        template< typename It, typename T, typename Compare >
+        It gallop_upper_back(It first, It last, const T &key, Compare cmp){
+            std::ptrdiff_t n = last - first, ofs = 1;
+            while(ofs <= n && cmp(key, *(last - ofs))) ofs *= 2;
+            return std::upper_bound(ofs <= n ? last - ofs + 1 : first, last - ofs/2, key, cmp);
+        }
+
+        /// The pending runs of a timsort call and the merges between them.
+        template< typename RandomIt, typename Compare >
+        class timsort_merger {
+            public:
+                timsort_merger(Compare cmp) : m_cmp(cmp) {}
+
+                /// Pushes the run [base;base+len), which must follow the previous one, and restores the stack invariants.
+                void push(RandomIt base, std::ptrdiff_t len){
+                    m_runs.push_back({ base, len });
+                    collapse();
+                }
+
+                /// Merges all the pending runs.
+                void finish(void){
+                    while(m_runs.size() > 1) {
+                        std::size_t n = m_runs.size() - 2;
+                        if(n > 0 && m_runs[n - 1].len < m_runs[n + 1].len) n--;
+                        merge_at(n);
+                    }
+                }
+
+            private:
+                using DataType = typename std::iterator_traits<RandomIt>::value_type;
+                struct run { RandomIt base; std::ptrdiff_t len; };
+
+                Compare m_cmp;
+                std::vector<run> m_runs;        //!< Pending runs, left to right.
+                std::vector<DataType> m_tmp;    //!< Scratch space for the smaller run of a merge.
+                std::ptrdiff_t m_min_gallop{ TIMSORT_MIN_GALLOP };
+
+                /*!
+                 * Merges runs until, for the topmost runs X, Y, Z (Z on top), both
+                 * len(X) > len(Y) + len(Z) and len(Y) > len(Z) hold. The run lengths then
+                 * grow at least as fast as the Fibonacci numbers, so there are O(log n)
+                 * pending runs and the merges stay balanced.
+                 */
+                void collapse(void){
+                    while(m_runs.size() > 1) {
+                        std::size_t n = m_runs.size() - 2;
+                        if((n > 0 && m_runs[n - 1].len <= m_runs[n].len + m_runs[n + 1].len)
+                                || (n > 1 && m_runs[n - 2].len <= m_runs[n - 1].len + m_runs[n].len)) {
+                            if(m_runs[n - 1].len < m_runs[n + 1].len) n--;
+                        }
+                        else if(m_runs[n].len > m_runs[n + 1].len) break;
+                        merge_at(n);
+                    }
+                }
+
+                /// Merges the runs i and i+1 of the stack.
+                void merge_at(std::size_t i){
+                    RandomIt base1 = m_runs[i].base;
+                    std::ptrdiff_t len1 = m_runs[i].len;
+                    RandomIt base2 = m_runs[i + 1].base;
+                    std::ptrdiff_t len2 = m_runs[i + 1].len;
+                    m_runs[i].len = len1 + len2;
+                    m_runs.erase(m_runs.begin() + i + 1);
+
+                    // the elements of run 1 not greater than run 2's first are already in place,
+                    RandomIt start = std::upper_bound(base1, base1 + len1, *base2, m_cmp);
+                    len1 -= start - base1;
+                    base1 = start;
+                    if(len1 == 0) return;
+                    // and so are the elements of run 2 not less than run 1's last.
+                    len2 = std::lower_bound(base2, base2 + len2, *(base1 + (len1 - 1)), m_cmp) - base2;
+                    if(len2 == 0) return;
+
+                    if(len1 <= len2) merge_lo(base1, len1, base2, len2);
+                    else merge_hi(base1, len1, base2, len2);
+                }
+
+                /// Merge front to back, with the (shorter) first run moved out to m_tmp.
+                void merge_lo(RandomIt base1, std::ptrdiff_t len1, RandomIt base2, std::ptrdiff_t len2){
+                    m_tmp.assign(std::make_move_iterator(base1), std::make_move_iterator(base1 + len1));
+                    auto c1 = m_tmp.begin(), end1 = m_tmp.end();
+                    RandomIt c2 = base2, end2 = base2 + len2, dest = base1;
+                    while(c1 != end1 && c2 != end2) {
+                        // one element at a time, until a run wins min_gallop times in a row.
+                        std::ptrdiff_t wins1 = 0, wins2 = 0;
+                        while(c1 != end1 && c2 != end2 && wins1 < m_min_gallop && wins2 < m_min_gallop) {
+                            if(m_cmp(*c2, *c1)) { *dest++ = std::move(*c2++); wins2++; wins1 = 0; }
+                            else { *dest++ = std::move(*c1++); wins1++; wins2 = 0; }
+                        }
+                        // galloping: move whole blocks while they stay long.
+                        while(c1 != end1 && c2 != end2) {
+                            auto g1 = gallop_upper(c1, end1, *c2, m_cmp);
+                            std::ptrdiff_t k1 = g1 - c1;
+                            dest = std::move(c1, g1, dest);
+                            c1 = g1;
+                            if(c1 == end1) break;
+                            *dest++ = std::move(*c2++);
+                            if(c2 == end2) break;
+                            RandomIt g2 = gallop_lower(c2, end2, *c1, m_cmp);
+                            std::ptrdiff_t k2 = g2 - c2;
+                            dest = std::move(c2, g2, dest);
+                            c2 = g2;
+                            if(c2 == end2) break;
+                            *dest++ = std::move(*c1++);
+                            if(m_min_gallop > 1) m_min_gallop--;
+                            if(k1 < TIMSORT_MIN_GALLOP && k2 < TIMSORT_MIN_GALLOP) {
+                                m_min_gallop += 2;  // galloping did not pay off: make it harder to enter.
+                                break;
+                            }
+                        }
+                    }
+                    // what is left of run 2 is already in place.
+                    std::move(c1, end1, dest);
+                }
+
+                /// Merge back to front, with the (shorter) second run moved out to m_tmp.
+                void merge_hi(RandomIt base1, std::ptrdiff_t len1, RandomIt base2, std::ptrdiff_t len2){
+                    m_tmp.assign(std::make_move_iterator(base2), std::make_move_iterator(base2 + len2));
+                    // cN points just past the elements of run N not merged yet.
+                    RandomIt c1 = base1 + len1, dest = base2 + len2;
+                    auto c2 = m_tmp.end(), begin2 = m_tmp.begin();
+                    while(c1 != base1 && c2 != begin2) {
+                        std::ptrdiff_t wins1 = 0, wins2 = 0;
+                        while(c1 != base1 && c2 != begin2 && wins1 < m_min_gallop && wins2 < m_min_gallop) {
+                            if(m_cmp(*(c2 - 1), *(c1 - 1))) { *--dest = std::move(*--c1); wins1++; wins2 = 0; }
+                            else { *--dest = std::move(*--c2); wins2++; wins1 = 0; }
+                        }
+                        while(c1 != base1 && c2 != begin2) {
+                            // run 1 elements greater than run 2's last go after it.
+                            RandomIt g1 = gallop_upper_back(base1, c1, *(c2 - 1), m_cmp);
+                            std::ptrdiff_t k1 = c1 - g1;
+                            dest = std::move_backward(g1, c1, dest);
+                            c1 = g1;
+                            if(c1 == base1) break;
+                            *--dest = std::move(*--c2);
+                            if(c2 == begin2) break;
+                            // run 2 elements not less than run 1's last go after it.
+                            auto g2 = gallop_lower_back(begin2, c2, *(c1 - 1), m_cmp);
+                            std::ptrdiff_t k2 = c2 - g2;
+                            dest = std::move_backward(g2, c2, dest);
+                            c2 = g2;
+                            if(c2 == begin2) break;
+                            *--dest = std::move(*--c1);
+                            if(m_min_gallop > 1) m_min_gallop--;
+                            if(k1 < TIMSORT_MIN_GALLOP && k2 < TIMSORT_MIN_GALLOP) {
+                                m_min_gallop += 2;
+                                break;
+                            }
+                        }
+                    }
+                    // what is left of run 1 is already in place.
+                    std::move_backward(begin2, c2, dest);
+                }
+        };
+    }
+
+    /*!
+     * Timsort: an adaptive, stable natural merge sort.
+     *
+     * The range is scanned for runs that are already sorted (strictly descending runs
+     * are reversed); runs shorter than the minimum run length (32 to 64 elements) are
+     * extended with binary insertion sort. Pending runs are merged following Timsort's
+     * stack invariants, and each merge first skips the prefix and suffix that are
+     * already in place, then gallops (exponential search) whenever one run keeps
+     * winning. On presorted input it does a single pass and no merge, O(n).
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void timsort(RandomIt first, RandomIt last, Compare cmp){
+        std::ptrdiff_t n = last - first;
+        if(n < 2) return;
+        if(n < detail::TIMSORT_MIN_MERGE) {
+            std::ptrdiff_t run = detail::timsort_count_run(first, last, cmp);
+            detail::binary_insertion(first, first + run, last, cmp);
+            return;
+        }
+        std::ptrdiff_t min_run = detail::timsort_min_run(n);
+        detail::timsort_merger<RandomIt, Compare> merger(cmp);
+        for(RandomIt base = first; base != last; ) {
+            std::ptrdiff_t run = detail::timsort_count_run(base, last, cmp);
+            if(run < min_run) {
+                std::ptrdiff_t forced = std::min(min_run, last - base);
+                detail::binary_insertion(base, base + run, base + forced, cmp);
+                run = forced;
+            }
+            merger.push(base, run);
+            base += run;
+        }
+        merger.finish();
+    }
+    //}}} TIMSORT
+
+    //{{{ PARALLEL SORTS
+    /// How the parallel sorts split their work.
+    struct parallel_options {
+        /// Total number of threads, the caller's included. 0 runs on thread_pool::shared(); 1 sorts sequentially;
+        /// otherwise the sort runs on the cached thread_pool::with_workers(threads - 1).
+        unsigned threads{0};
+        /// Slices with up to this many elements are sorted (or merged) sequentially.
+        std::ptrdiff_t cutoff{1 << 14};
+    };
+
+    namespace detail {
+        /// Calls `fn(pool)` with the pool that `opt` asks for, or with nullptr for a sequential run.
+        template< typename Fn >
+        void with_pool(const parallel_options &opt, Fn fn){
+            if(opt.threads == 1) fn(static_cast<thread_pool *>(nullptr));
+            else if(opt.threads == 0) fn(&thread_pool::shared());
+            else fn(&thread_pool::with_workers(opt.threads - 1));
+        }
+
+        /*!
+         * Co-rank: splits the stable merge of [l;l+nl) and [r;r+nr) at output position k.
+         * @return the i such that the first k merged elements are l[0;i) and r[0;k-i).
+         */
+        template< typename It, typename Compare >
+        std::ptrdiff_t co_rank(std::ptrdiff_t k, It l, std::ptrdiff_t nl, It r, std::ptrdiff_t nr, Compare cmp){
+            std::ptrdiff_t lo = std::max<std::ptrdiff_t>(0, k - nr);
+            std::ptrdiff_t hi = std::min(k, nl);
+            while(lo < hi) {
+                std::ptrdiff_t i = lo + (hi - lo)/2;
+                // l[i] is among the first k if it goes before r[k-i-1] (ties go left).
+                if(!cmp(*(r + (k - i - 1)), *(l + i))) lo = i + 1;
+                else hi = i;
+            }
+            return lo;
+        }
+
+        /// Stable merge of [l;l+nl) and [r;r+nr) into `out`, split in halves by co-ranking while it is big.
+        template< typename InIt, typename OutIt, typename Compare >
+        void parallel_merge(InIt l, std::ptrdiff_t nl, InIt r, std::ptrdiff_t nr, OutIt out,
+                Compare cmp, std::ptrdiff_t cutoff, task_group &group){
+            while(nl + nr > cutoff && nl > 0 && nr > 0) {
+                std::ptrdiff_t k = (nl + nr)/2;
+                std::ptrdiff_t i = co_rank(k, l, nl, r, nr, cmp);
+                group.run([=, &group]{ parallel_merge(l, i, r, k - i, out, cmp, cutoff, group); });
+                l += i; nl -= i;
+                r += k - i; nr -= k - i;
+                out += k;
+            }
+            merge_into(l, l + nl, r, r + nr, out, cmp);
+        }
+
+        /// Parallel version of merge_halves().
+        template< typename InIt, typename OutIt, typename Compare >
+        void parallel_merge_halves(InIt src, std::ptrdiff_t mid, std::ptrdiff_t n, OutIt dst, Compare cmp,
+                std::ptrdiff_t cutoff, thread_pool &pool){
+            if(!cmp(*(src + mid), *(src + mid - 1))) std::move(src, src + n, dst);
+            else {
+                task_group merges(pool);
+                parallel_merge(src, mid, src + mid, n - mid, dst, cmp, cutoff, merges);
+                merges.wait();
+            }
+        }
+
+        /// Parallel version of mergesort_pingpong(): sorts the n elements of `a` into `b` (into_b) or back into `a`.
+        template< typename It1, typename It2, typename Compare >
+        void parallel_mergesort_pingpong(It1 a, It2 b, std::ptrdiff_t n, bool into_b, Compare cmp,
+                std::ptrdiff_t cutoff, thread_pool &pool){
+            if(n <= cutoff) {
+                mergesort_pingpong(a, b, n, into_b, cmp);
+                return;
+            }
+            std::ptrdiff_t mid = n/2;
+            {
+                task_group halves(pool);
+                halves.run([=, &pool]{ parallel_mergesort_pingpong(a, b, mid, !into_b, cmp, cutoff, pool); });
+                parallel_mergesort_pingpong(a + mid, b + mid, n - mid, !into_b, cmp, cutoff, pool);
+                halves.wait();
+            }
+            if(into_b) parallel_merge_halves(a, mid, n, b, cmp, cutoff, pool);
+            else parallel_merge_halves(b, mid, n, a, cmp, cutoff, pool);
+        }
+
+        /// Introsort loop that hands one side of every partition to the pool while the slices are big.
+        template< typename RandomIt, typename Compare >
+        void parallel_quick_loop(RandomIt first, RandomIt last, int depth, Compare cmp,
+                std::ptrdiff_t cutoff, task_group &group){
+            while(last - first > cutoff) {
+                if(depth == 0) {
+                    heap_sort(first, last, cmp);
+                    return;
+                }
+                depth--;
+                choose_pivot(first, last, cmp);
+                RandomIt p = hoare_partition(first, last, cmp);
+                RandomIt l_last = p, r_first = p + 1;
+                group.run([=, &group]{ parallel_quick_loop(first, l_last, depth, cmp, cutoff, group); });
+                first = r_first;
+            }
+            introsort_loop(first, last, depth, cmp);
+        }
+    }
+
+    /*!
+     * Parallel merge sort.
+     *
+     * Both halves are sorted as parallel tasks, then merged by a parallel merge that
+     * splits the output in halves with a co-rank binary search, so the merges do not
+     * become the sequential bottleneck at the top levels. Uses one scratch buffer of
+     * the size of the range, like mergesort_buffered(), and is stable.
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @param opt Thread count and sequential cutoff.
+     */
+    template< typename RandomIt, typename Compare >
+    void parallel_mergesort(RandomIt first, RandomIt last, Compare cmp, const parallel_options &opt = {}){
+        using DataType = typename std::iterator_traits<RandomIt>::value_type;
+        std::ptrdiff_t n = last - first;
+        if(n < 2) return;
+        std::ptrdiff_t cutoff = std::max<std::ptrdiff_t>(opt.cutoff, 2);
+        std::vector<DataType> buffer(n);
+        detail::with_pool(opt, [&](thread_pool *pool){
+            if(pool == nullptr) detail::mergesort_pingpong(first, buffer.begin(), n, false, cmp);
+            else detail::parallel_mergesort_pingpong(first, buffer.begin(), n, false, cmp, cutoff, *pool);
+        });
+    }
+
+    /*!
+     * Parallel quick sort: introsort whose partitions hand their left side to the
+     * thread pool as a new task while the slices are larger than the cutoff.
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @param opt Thread count and sequential cutoff.
+     */
+    template< typename RandomIt, typename Compare >
+    void parallel_quick(RandomIt first, RandomIt last, Compare cmp, const parallel_options &opt = {}){
+        std::ptrdiff_t n = last - first;
+        int depth = 0;
+        while(n > 1) { n >>= 1; depth += 2; }
+        std::ptrdiff_t cutoff = std::max(opt.cutoff, detail::INSERTION_CUTOFF);
+        detail::with_pool(opt, [&](thread_pool *pool){
+            if(pool == nullptr) detail::introsort_loop(first, last, depth, cmp);
+            else {
+                task_group group(*pool);
+                detail::parallel_quick_loop(first, last, depth, cmp, cutoff, group);
+                group.wait();
+            }
+        });
+    }
+    //}}} PARALLEL SORTS
+
     //{{{ RADIX SORT
     /*!
      * This function implements the Radix Sorting Algorithm based on the **less significant digit** (LSD).
@@ -293,7 +1263,7 @@ namespace sa { // sa = sorting algorithms
         // main loop; max_d times
         for(size_t i = 0; i < max_d; i++) {
             // inter loop; insert each element into its respective bucket depending on which digit position is being analyzed
-            std::for_each(first, last, [&buckets, i](DataType value){ buckets[(int)(value/std::pow(10, i))%10].push_back(value); });
+            std::for_each(first, last, [&buckets, i](DataType &value){ buckets[(int)(value/std::pow(10, i))%10].push_back(std::move(value)); });
             // ==============================================================
             // What the for_each above does is:
             // --------------------------------------------------------------
@@ -303,16 +1273,448 @@ namespace sa { // sa = sorting algorithms
             // 3rd pass: 123/100 = 1; 1 % 10 = 1.   buckets[1].push_back(123).
             // 4th pass: 123/1000 = 0; 0 % 10 = 0.  buckets[0].push_back(123).
             
-            // copy from buckets to the original range
+            // move from buckets to the original range
             FwrdIt destination = first;
             for(auto &b : buckets) {
-                destination = std::copy(b.begin(), b.end(), destination);
+                destination = std::move(b.begin(), b.end(), destination);
                 b.clear();
             }
         }
     }
     //}}} RADIX SORT
 
+    //{{{ LSD RADIX SORT
+    namespace detail {
+        /// Unsigned integer type with the same size as T.
+        template< typename T >
+        using radix_key_t = typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type;
+
+        /*!
+         * Maps a value to an unsigned key whose natural order matches the order of the values.
+         *
+         * Unsigned integers are taken as is. Signed integers get their sign bit flipped,
+         * so that negative values come first. IEEE floats get their sign bit set if
+         * positive, or all their bits flipped if negative (which also reverses the order
+         * among negative values).
+         */
+        template< typename T >
+        radix_key_t<T> radix_key(T value){
+            using Key = radix_key_t<T>;
+            constexpr Key SIGN = Key{1} << (8*sizeof(T) - 1);
+            Key key;
+            std::memcpy(&key, &value, sizeof(T));
+            if(std::is_floating_point<T>::value) return (key & SIGN) ? ~key : key | SIGN;
+            if(std::is_signed<T>::value) return key ^ SIGN;
+            return key;
+        }
+    }
+
+    /*!
+     * Radix sort on the **least significant digit**, with 8-bit digits.
+     *
+     * A first pass over the range counts the occurrences of every digit value at every
+     * byte position. Then, for each byte, the prefix sums of its counts give the
+     * position of every element in the output, and one scatter pass moves the elements
+     * between the range and a single scratch buffer. A byte that is the same for every
+     * key does not change the order, so its pass is skipped.
+     *
+     * @note Works with 32- and 64-bit integers (signed or not) and with `float`/`double`.
+     *       There is no need for a comparison function to be passed as argument.
+     *
+     * @param first Pointer/iterator to the beginning of the range we wish to sort.
+     * @param last Pointer/iterator to the location just past the last valid value of the range we wish to sort.
+     * @tparam RandomIt A random access iterator to the range we need to sort.
+     */
+    template< typename RandomIt >
+    void radix_lsd(RandomIt first, RandomIt last){
+        using DataType = typename std::iterator_traits<RandomIt>::value_type;
+        static_assert(std::is_arithmetic<DataType>::value && (sizeof(DataType) == 4 || sizeof(DataType) == 8),
+                      "radix_lsd sorts 32- and 64-bit integers and floating point numbers");
+        constexpr int RADIX = 256;
+        constexpr int N_BYTES = sizeof(DataType);
+
+        std::ptrdiff_t n = last - first;
+        if(n < 2) return;
+
+        // one histogram per byte, all filled in a single pass.
+        std::vector<std::array<std::size_t, RADIX>> counts(N_BYTES);
+        for(auto &c : counts) c.fill(0);
+        for(RandomIt it = first; it != last; ++it) {
+            auto key = detail::radix_key(*it);
+            for(int b = 0; b < N_BYTES; b++) counts[b][(key >> (8*b)) & 0xFF]++;
+        }
+
+        std::vector<DataType> buffer(n);
+        bool in_buffer = false;  // whether the latest pass wrote into the buffer
+        for(int b = 0; b < N_BYTES; b++) {
+            auto &count = counts[b];
+            // every key has the same digit: this pass would not move anything.
+            if(count[(detail::radix_key(*first) >> (8*b)) & 0xFF] == static_cast<std::size_t>(n)) continue;
+            // exclusive prefix sums: where the first element with each digit goes.
+            std::size_t sum = 0;
+            for(auto &c : count) { std::size_t t = c; c = sum; sum += t; }
+            auto scatter = [&](auto src, auto dst){
+                for(std::ptrdiff_t i = 0; i < n; i++) {
+                    auto digit = (detail::radix_key(src[i]) >> (8*b)) & 0xFF;
+                    dst[count[digit]++] = std::move(src[i]);
+                }
+            };
+            if(in_buffer) scatter(buffer.begin(), first);
+            else scatter(first, buffer.begin());
+            in_buffer = !in_buffer;
+        }
+        if(in_buffer) std::move(buffer.begin(), buffer.end(), first);
+    }
+    //}}} LSD RADIX SORT
+
+    //{{{ AMERICAN FLAG SORT
+    namespace detail {
+        /// Buckets with up to this many elements are left for insertion sort.
+        constexpr std::ptrdiff_t FLAG_INSERTION_CUTOFF = 32;
+
+        /// Key type T widened to at least 32 bits, keeping its signedness.
+        template< typename T >
+        using flag_key_t = typename std::conditional<(sizeof(T) >= 4), T,
+              typename std::conditional<std::is_signed<T>::value, std::int32_t, std::uint32_t>::type>::type;
+
+        /// American flag sort of [first;last) on byte `byte` of the keys, then recursively on the lower bytes.
+        template< typename RandomIt, typename KeyOf >
+        void american_flag_pass(RandomIt first, RandomIt last, int byte, KeyOf key_of){
+            auto digit = [&](const auto &value){ return (key_of(value) >> (8*byte)) & 0xFF; };
+            std::ptrdiff_t n = last - first;
+            if(n <= FLAG_INSERTION_CUTOFF) {
+                sa::insertion(first, last, [&](const auto &a, const auto &b){ return key_of(a) < key_of(b); });
+                return;
+            }
+
+            std::array<std::ptrdiff_t, 256> count;
+            count.fill(0);
+            for(RandomIt it = first; it != last; ++it) count[digit(*it)]++;
+
+            // bucket b is [start[b];start[b+1]); next[b] is its first slot not yet filled.
+            std::array<std::ptrdiff_t, 257> start;
+            start[0] = 0;
+            for(int b = 0; b < 256; b++) start[b + 1] = start[b] + count[b];
+            std::array<std::ptrdiff_t, 256> next;
+            std::copy(start.begin(), start.end() - 1, next.begin());
+
+            // a bucket that holds everything needs no permutation on this byte.
+            if(count[digit(*first)] != n) {
+                // cycle leader permutation: the element at the first open slot of bucket b
+                // is swapped into its own bucket until an element of bucket b comes back.
+                for(int b = 0; b < 256; b++) {
+                    while(next[b] < start[b + 1]) {
+                        auto value = std::move(*(first + next[b]));
+                        auto d = digit(value);
+                        while(static_cast<int>(d) != b) {
+                            using std::swap;
+                            swap(value, *(first + next[d]++));
+                            d = digit(value);
+                        }
+                        *(first + next[b]++) = std::move(value);
+                    }
+                }
+            }
+
+            if(byte == 0) return;
+            for(int b = 0; b < 256; b++)
+                if(count[b] > 1) american_flag_pass(first + start[b], first + start[b + 1], byte - 1, key_of);
+        }
+    }
+
+    /*!
+     * In-place MSD radix sort (American flag sort) with 8-bit digits.
+     *
+     * Starting at the most significant byte, counts the elements of each of the 256
+     * buckets, moves every element to its bucket in place by following permutation
+     * cycles, and then sorts each bucket on the next byte. Buckets with up to 32
+     * elements go to insertion sort instead. Apart from the recursion (one level per
+     * key byte) it takes O(1) extra memory. The sort is not stable.
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param key A functor that returns the integer (or floating point) key of an element;
+     *   elements are sorted by increasing key, without any comparison function.
+     */
+    template< typename RandomIt, typename KeyExtractor >
+    void american_flag(RandomIt first, RandomIt last, KeyExtractor key){
+        using DataType = typename std::iterator_traits<RandomIt>::value_type;
+        using KeyType = typename std::decay<decltype(key(std::declval<const DataType &>()))>::type;
+        static_assert(std::is_arithmetic<KeyType>::value && sizeof(KeyType) <= 8,
+                      "american_flag needs an integer or floating point key of up to 64 bits");
+        using Wide = detail::flag_key_t<KeyType>;
+        // order preserving unsigned key, as in radix_lsd().
+        auto key_of = [&](const DataType &value){ return detail::radix_key(static_cast<Wide>(key(value))); };
+        detail::american_flag_pass(first, last, static_cast<int>(sizeof(Wide)) - 1, key_of);
+    }
+
+    /// American flag sort of a range of integer or floating point values, keyed by the values themselves.
+    template< typename RandomIt >
+    void american_flag(RandomIt first, RandomIt last){
+        american_flag(first, last, [](const auto &value){ return value; });
+    }
+    //}}} AMERICAN FLAG SORT
+
+    //{{{ INDIRECT SORT
+    /*!
+     * Rearranges a range so that position i receives the element that was at position perm[i].
+     *
+     * Each cycle of the permutation is followed once: every element is moved a single
+     * time, plus one temporary per cycle, and no second copy of the range is needed.
+     *
+     * @param first The first element in the range we want to rearrange.
+     * @param last Past the last element in the range we want to rearrange.
+     * @param perm The beginning of `last - first` indices forming a permutation of 0, 1, ..., n-1.
+     *   They are used to mark the positions already in place: on return they hold 0, 1, ..., n-1.
+     */
+    template< typename RandomIt, typename IndexIt >
+    void apply_permutation(RandomIt first, RandomIt last, IndexIt perm){
+        using Index = typename std::iterator_traits<IndexIt>::value_type;
+        Index n = static_cast<Index>(last - first);
+        for(Index i = 0; i < n; i++) {
+            if(perm[i] == i) continue;
+            // the cycle starting at i: each position takes the element of the next one.
+            auto value = std::move(*(first + i));
+            Index j = i;
+            while(perm[j] != i) {
+                Index k = perm[j];
+                *(first + j) = std::move(*(first + k));
+                perm[j] = j;
+                j = k;
+            }
+            *(first + j) = std::move(value);
+            perm[j] = j;
+        }
+    }
+
+    /*!
+     * Sorts a range of heavy elements through an array of indices.
+     *
+     * The indices 0, 1, ..., n-1 are sorted by the elements they refer to, so the
+     * sorting algorithm only ever moves indices, and the elements are then moved once
+     * each to their final position by apply_permutation(). The sort is stable if `sort` is.
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @param sort The algorithm that sorts the indices, called as `sort(index_first, index_last, index_cmp)`;
+     *   e.g. `[](auto f, auto l, auto c){ sa::timsort(f, l, c); }`.
+     */
+    template< typename RandomIt, typename Compare, typename Sorter >
+    void indirect_sort(RandomIt first, RandomIt last, Compare cmp, Sorter sort){
+        std::vector<std::size_t> perm(last - first);
+        std::iota(perm.begin(), perm.end(), std::size_t{0});
+        sort(perm.begin(), perm.end(), [first, &cmp](std::size_t a, std::size_t b){
+            return cmp(*(first + a), *(first + b));
+        });
+        apply_permutation(first, last, perm.begin());
+    }
+
+    /// Indirect sort of a range, with introsort sorting the indices.
+    template< typename RandomIt, typename Compare >
+    void indirect_sort(RandomIt first, RandomIt last, Compare cmp){
+        indirect_sort(first, last, cmp, [](auto f, auto l, auto c){ introsort(f, l, c); });
+    }
+
+    /*!
+     * Sorts a range of heavy elements by a key extracted from each of them.
+     *
+     * The (key, index) pairs are built once and sorted by key, so the comparisons read
+     * the compact pairs instead of the elements and no key is extracted twice. The
+     * elements are then moved once each to their final position by apply_permutation().
+     * The sort is stable if `sort` is.
+     *
+     * @param first The first element in the range we want to sort.
+     * @param last Past the last element in the range we want to sort.
+     * @param key A functor that returns the key of an element; elements are sorted by increasing key, with `<`.
+     * @param sort The algorithm that sorts the pairs, called as `sort(pair_first, pair_last, pair_cmp)`;
+     *   `pair.first` is the key, so e.g. `[](auto f, auto l, auto){ sa::american_flag(f, l, [](auto &p){ return p.first; }); }`
+     *   sorts integer keys by radix.
+     */
+    template< typename RandomIt, typename KeyExtractor, typename Sorter >
+    void sort_by_key(RandomIt first, RandomIt last, KeyExtractor key, Sorter sort){
+        using DataType = typename std::iterator_traits<RandomIt>::value_type;
+        using KeyType = typename std::decay<decltype(key(std::declval<const DataType &>()))>::type;
+        std::vector<std::pair<KeyType, std::size_t>> keyed;
+        keyed.reserve(last - first);
+        for(std::size_t i = 0; first + i != last; i++) keyed.emplace_back(key(*(first + i)), i);
+        sort(keyed.begin(), keyed.end(), [](const std::pair<KeyType, std::size_t> &a, const std::pair<KeyType, std::size_t> &b){
+            return a.first < b.first;
+        });
+        std::vector<std::size_t> perm(keyed.size());
+        for(std::size_t i = 0; i < keyed.size(); i++) perm[i] = keyed[i].second;
+        apply_permutation(first, last, perm.begin());
+    }
+
+    /// Sort by key of a range, with introsort sorting the (key, index) pairs.
+    template< typename RandomIt, typename KeyExtractor >
+    void sort_by_key(RandomIt first, RandomIt last, KeyExtractor key){
+        sort_by_key(first, last, key, [](auto f, auto l, auto c){ introsort(f, l, c); });
+    }
+    //}}} INDIRECT SORT
+
+    //{{{ INSTRUMENTATION
+    /*
+    Counting of the operations an algorithm performs, to check it against its cost model.
+    Nothing here touches the algorithms: a sort is instrumented by running it on
+    counted<T> elements with a counting_compare comparator, and costs nothing otherwise.
+    The scratch buffers of counted<T> elements, from new[] or std::vector, are counted
+    as allocations by counted<T> itself and by the std::allocator of counted<T> below.
+    */
+
+    /// Operations counted since the last reset_counts().
+    struct operation_counts {
+        std::uint64_t comparisons{0};   //!< Calls to a counting_compare.
+        std::uint64_t swaps{0};         //!< Swaps of counted values: std::iter_swap, or `using std::swap; swap(a, b)`, as the algorithms do.
+        std::uint64_t moves{0};         //!< Move constructions and assignments of counted values (a swap is not counted as moves).
+        std::uint64_t copies{0};        //!< Copy constructions and assignments of counted values.
+        std::uint64_t allocations{0};   //!< Arrays of counted values allocated, through new[] or std::allocator.
+    };
+
+    namespace detail {
+        /// The running counts; atomic, since the parallel sorts count from several threads.
+        struct operation_counters {
+            std::atomic<std::uint64_t> comparisons{0}, swaps{0}, moves{0}, copies{0}, allocations{0};
+        };
+
+        inline operation_counters & counters(void){
+            static operation_counters c;
+            return c;
+        }
+
+        inline void count(std::atomic<std::uint64_t> &counter){
+            counter.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// Sets every count to zero.
+    inline void reset_counts(void){
+        auto &c = detail::counters();
+        for(auto *counter : {&c.comparisons, &c.swaps, &c.moves, &c.copies, &c.allocations})
+            counter->store(0, std::memory_order_relaxed);
+    }
+
+    /// Returns the operations counted since the last reset_counts().
+    inline operation_counts read_counts(void){
+        auto &c = detail::counters();
+        operation_counts counts;
+        counts.comparisons = c.comparisons.load(std::memory_order_relaxed);
+        counts.swaps = c.swaps.load(std::memory_order_relaxed);
+        counts.moves = c.moves.load(std::memory_order_relaxed);
+        counts.copies = c.copies.load(std::memory_order_relaxed);
+        counts.allocations = c.allocations.load(std::memory_order_relaxed);
+        return counts;
+    }
+
+    /// Comparator that counts its calls and forwards them to `Compare`.
+    template< typename Compare >
+    class counting_compare {
+        public:
+            explicit counting_compare(Compare cmp) : m_cmp(cmp) {}
+            template< typename A, typename B >
+            bool operator()(const A &a, const B &b) const {
+                detail::count(detail::counters().comparisons);
+                return m_cmp(a, b);
+            }
+        private:
+            Compare m_cmp;
+    };
+
+    /// Wraps a comparator into a counting_compare.
+    template< typename Compare >
+    counting_compare<Compare> make_counting_compare(Compare cmp){ return counting_compare<Compare>(cmp); }
+
+    /*!
+     * A value of type T that counts how often it is copied, moved and swapped.
+     *
+     * Building one from a T, and comparing two of them with `<`, is not counted:
+     * comparisons are counted by counting_compare.
+     */
+    template< typename T >
+    class counted {
+        public:
+            counted() = default;
+            explicit counted(const T &value) : m_value(value) {}
+            counted(const counted &other) : m_value(other.m_value) { detail::count(detail::counters().copies); }
+            counted(counted &&other) noexcept : m_value(std::move(other.m_value)) { detail::count(detail::counters().moves); }
+            counted & operator=(const counted &other){
+                detail::count(detail::counters().copies);
+                m_value = other.m_value;
+                return *this;
+            }
+            counted & operator=(counted &&other) noexcept {
+                detail::count(detail::counters().moves);
+                m_value = std::move(other.m_value);
+                return *this;
+            }
+
+            /// The wrapped value.
+            const T & get(void) const { return m_value; }
+
+            friend void swap(counted &a, counted &b) noexcept {
+                detail::count(detail::counters().swaps);
+                using std::swap;
+                swap(a.m_value, b.m_value);
+            }
+            friend bool operator<(const counted &a, const counted &b){ return a.m_value < b.m_value; }
+
+            // Arrays of counted values are scratch buffers: counts their allocation.
+            static void * operator new[](std::size_t size){
+                detail::count(detail::counters().allocations);
+                return ::operator new[](size);
+            }
+            static void operator delete[](void *p) noexcept { ::operator delete[](p); }
+        private:
+            T m_value{};
+    };
+
+    /// Whether T is a counted value.
+    template< typename T > struct is_counted : std::false_type {};
+    template< typename T > struct is_counted<counted<T>> : std::true_type {};
+    //}}} INSTRUMENTATION
+
 };
+
+namespace std {
+    /*!
+     * The default allocator of counted values, which counts every allocation.
+     *
+     * The algorithms get their buffers from std::vector<T>, so this is how the
+     * allocations of an instrumented run are seen, without replacing operator new.
+     */
+    template< typename T >
+    struct allocator<sa::counted<T>> {
+        using value_type = sa::counted<T>;
+        using pointer = value_type *;
+        using const_pointer = const value_type *;
+        using reference = value_type &;
+        using const_reference = const value_type &;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+        template< typename U > struct rebind { using other = allocator<U>; };
+
+        allocator() noexcept = default;
+        template< typename U >
+        allocator(const allocator<U> &) noexcept {}
+
+        value_type * allocate(std::size_t n){
+            if(n > max_size()) throw std::bad_array_new_length();
+            sa::detail::count(sa::detail::counters().allocations);
+            return static_cast<value_type *>(::operator new(n * sizeof(value_type)));
+        }
+        void deallocate(value_type *p, std::size_t) noexcept { ::operator delete(p); }
+        std::size_t max_size(void) const noexcept { return std::numeric_limits<std::size_t>::max() / sizeof(value_type); }
+
+        template< typename U, typename... Args >
+        void construct(U *p, Args&&... args){ ::new(static_cast<void *>(p)) U(std::forward<Args>(args)...); }
+        template< typename U >
+        void destroy(U *p){ p->~U(); }
+
+        friend bool operator==(const allocator &, const allocator &) noexcept { return true; }
+        friend bool operator!=(const allocator &, const allocator &) noexcept { return false; }
+    };
+}
 #endif // SORTING_H
 
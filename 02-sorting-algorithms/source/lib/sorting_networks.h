@@ -0,0 +1,218 @@
+/**
+ * Bitonic sorting networks for up to 64 `int32_t` or `float` values.
+ *
+ * The values are padded up to 8, 16, 32 or 64 elements and kept in AVX2 registers
+ * (8 lanes each) while the network runs: comparators between lanes of different
+ * registers are a plain min/max pair, comparators inside a register shuffle the
+ * register against itself and blend the min/max results. The network has no
+ * data-dependent branches, so its cost is the same for every input.
+ *
+ * AVX2 is detected at run time; without it (or when compiled with SA_NO_SIMD) the
+ * same network runs on scalars.
+ * @date July 5th, 2021
+ * @file sorting_networks.h
+ */
+
+#ifndef SORTING_NETWORKS_H
+#define SORTING_NETWORKS_H
+
+#include <cassert>      // assert
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::int32_t
+#include <cstring>      // std::memcpy
+#include <limits>       // std::numeric_limits
+#include <type_traits>  // std::integral_constant
+
+#if !defined(SA_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SA_NETWORK_AVX2 1
+#include <immintrin.h>
+/// Compiles a function for AVX2, whatever the flags of the translation unit.
+#define SA_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define SA_NETWORK_AVX2 0
+#endif
+
+namespace sa { // sa = sorting algorithms
+
+    /// Largest range network_sort() accepts.
+    constexpr std::size_t NETWORK_MAX = 64;
+
+    namespace detail {
+        /// Sorts a[0;n) with the bitonic network, n a power of 2, one compare-exchange at a time.
+        template< typename T >
+        void bitonic_scalar(T *a, std::size_t n){
+            for(std::size_t k = 2; k <= n; k <<= 1)
+                for(std::size_t j = k >> 1; j > 0; j >>= 1)
+                    for(std::size_t i = 0; i < n; i++) {
+                        std::size_t p = i ^ j;
+                        if(p < i) continue;
+                        T x = a[i], y = a[p];
+                        T lo = y < x ? y : x;
+                        T hi = y < x ? x : y;
+                        bool ascending = (i & k) == 0;
+                        a[i] = ascending ? lo : hi;
+                        a[p] = ascending ? hi : lo;
+                    }
+        }
+
+#if SA_NETWORK_AVX2
+        /*!
+         * Blend masks for the comparators inside a register, lane l set to take the max.
+         * upper[j] serves the steps whose direction depends on the register only (k >= 8);
+         * inner[k][j] the steps with k < 8, whose direction changes from lane to lane.
+         */
+        struct network_masks {
+            alignas(32) std::int32_t upper[5][8];
+            alignas(32) std::int32_t inner[5][5][8];
+            network_masks(){
+                for(int j = 1; j <= 4; j <<= 1)
+                    for(int l = 0; l < 8; l++) {
+                        upper[j][l] = (l & j) ? -1 : 0;
+                        for(int k = 2; k <= 4; k <<= 1)
+                            inner[k][j][l] = (((l & j) != 0) != ((l & k) != 0)) ? -1 : 0;
+                    }
+            }
+            static const network_masks & get(void){
+                static const network_masks masks;
+                return masks;
+            }
+        };
+
+        /// AVX2 operations on 8 lanes of int32_t.
+        struct avx2_i32 {
+            using value_type = std::int32_t;
+            using reg = __m256i;
+            SA_AVX2_TARGET static reg load(const value_type *p){ return _mm256_load_si256(reinterpret_cast<const __m256i *>(p)); }
+            SA_AVX2_TARGET static void store(value_type *p, reg v){ _mm256_store_si256(reinterpret_cast<__m256i *>(p), v); }
+            SA_AVX2_TARGET static reg min(reg a, reg b){ return _mm256_min_epi32(a, b); }
+            SA_AVX2_TARGET static reg max(reg a, reg b){ return _mm256_max_epi32(a, b); }
+            /// Lanes of b where the mask is set, of a elsewhere.
+            SA_AVX2_TARGET static reg blend(reg a, reg b, const std::int32_t *mask){
+                return _mm256_blendv_epi8(a, b, _mm256_load_si256(reinterpret_cast<const __m256i *>(mask)));
+            }
+            /// Lane l takes lane l^j.
+            SA_AVX2_TARGET static reg partner(reg v, int j){
+                if(j == 1) return _mm256_shuffle_epi32(v, 0xB1);
+                if(j == 2) return _mm256_shuffle_epi32(v, 0x4E);
+                return _mm256_permute2x128_si256(v, v, 1);
+            }
+        };
+
+        /// AVX2 operations on 8 lanes of float.
+        struct avx2_f32 {
+            using value_type = float;
+            using reg = __m256;
+            SA_AVX2_TARGET static reg load(const value_type *p){ return _mm256_load_ps(p); }
+            SA_AVX2_TARGET static void store(value_type *p, reg v){ _mm256_store_ps(p, v); }
+            SA_AVX2_TARGET static reg min(reg a, reg b){ return _mm256_min_ps(a, b); }
+            SA_AVX2_TARGET static reg max(reg a, reg b){ return _mm256_max_ps(a, b); }
+            SA_AVX2_TARGET static reg blend(reg a, reg b, const std::int32_t *mask){
+                return _mm256_blendv_ps(a, b, _mm256_castsi256_ps(_mm256_load_si256(reinterpret_cast<const __m256i *>(mask))));
+            }
+            SA_AVX2_TARGET static reg partner(reg v, int j){
+                if(j == 1) return _mm256_permute_ps(v, 0xB1);
+                if(j == 2) return _mm256_permute_ps(v, 0x4E);
+                return _mm256_permute2f128_ps(v, v, 1);
+            }
+        };
+
+        /// Sorts the 8*R values at a (32-byte aligned) with the bitonic network, in R AVX2 registers.
+        template< typename Ops, int R >
+        SA_AVX2_TARGET void bitonic_avx2(typename Ops::value_type *a){
+            const network_masks &masks = network_masks::get();
+            typename Ops::reg v[R];
+            for(int r = 0; r < R; r++) v[r] = Ops::load(a + 8*r);
+            for(int k = 2; k <= 8*R; k <<= 1) {
+                for(int j = k >> 1; j > 0; j >>= 1) {
+                    if(j >= 8) {
+                        // partners sit in the same lane of another register.
+                        for(int r = 0; r < R; r++) {
+                            int q = r ^ (j >> 3);
+                            if(q < r) continue;
+                            auto lo = Ops::min(v[r], v[q]);
+                            auto hi = Ops::max(v[r], v[q]);
+                            bool ascending = ((8*r) & k) == 0;
+                            v[r] = ascending ? lo : hi;
+                            v[q] = ascending ? hi : lo;
+                        }
+                    }
+                    else {
+                        // partners sit in the same register.
+                        for(int r = 0; r < R; r++) {
+                            auto p = Ops::partner(v[r], j);
+                            auto lo = Ops::min(v[r], p);
+                            auto hi = Ops::max(v[r], p);
+                            if(k < 8) v[r] = Ops::blend(lo, hi, masks.inner[k][j]);
+                            else if(((8*r) & k) == 0) v[r] = Ops::blend(lo, hi, masks.upper[j]);
+                            else v[r] = Ops::blend(hi, lo, masks.upper[j]);
+                        }
+                    }
+                }
+            }
+            for(int r = 0; r < R; r++) Ops::store(a + 8*r, v[r]);
+        }
+
+        /// Whether the CPU we are running on supports AVX2.
+        inline bool has_avx2(void){
+            // __builtin_cpu_init() must run first when called before the constructors, e.g. from another static initializer.
+            static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+            return avx2;
+        }
+
+        /// Picks the AVX2 operations for T.
+        template< typename T > struct avx2_ops;
+        template<> struct avx2_ops<std::int32_t> { using type = avx2_i32; };
+        template<> struct avx2_ops<float> { using type = avx2_f32; };
+#endif
+
+        /// Sorts the padded block a[0;n), n in {8, 16, 32, 64}.
+        template< typename T >
+        void network_block(T *a, std::size_t n){
+#if SA_NETWORK_AVX2
+            if(has_avx2()) {
+                using Ops = typename avx2_ops<T>::type;
+                switch(n) {
+                    case 8:  bitonic_avx2<Ops, 1>(a); return;
+                    case 16: bitonic_avx2<Ops, 2>(a); return;
+                    case 32: bitonic_avx2<Ops, 4>(a); return;
+                    default: bitonic_avx2<Ops, 8>(a); return;
+                }
+            }
+#endif
+            bitonic_scalar(a, n);
+        }
+    }
+
+    /// Whether network_sort() accepts values of type T.
+    template< typename T >
+    struct is_network_sortable : std::integral_constant<bool,
+        std::is_same<T, std::int32_t>::value || std::is_same<T, float>::value> {};
+
+    /*!
+     * Sorts up to 64 `int32_t` or `float` values in increasing order with a bitonic
+     * sorting network (AVX2 when available, scalar otherwise).
+     *
+     * The range is padded with the largest value of the type up to the next of 8, 16,
+     * 32 or 64 elements. The sort is not stable, and NaNs are not supported.
+     *
+     * @param data Pointer to the values to sort.
+     * @param n Number of values; **must** be at most NETWORK_MAX.
+     */
+    template< typename T >
+    void network_sort(T *data, std::size_t n){
+        static_assert(is_network_sortable<T>::value, "network_sort sorts int32_t and float values");
+        assert(n <= NETWORK_MAX);
+        if(n < 2) return;
+        std::size_t block = 8;
+        while(block < n) block <<= 1;
+        alignas(32) T buffer[NETWORK_MAX];
+        std::memcpy(buffer, data, n * sizeof(T));
+        const T pad = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                           : std::numeric_limits<T>::max();
+        for(std::size_t i = n; i < block; i++) buffer[i] = pad;
+        detail::network_block(buffer, block);
+        std::memcpy(data, buffer, n * sizeof(T));
+    }
+}
+
+#endif // SORTING_NETWORKS_H
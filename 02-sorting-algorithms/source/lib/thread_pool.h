@@ -0,0 +1,207 @@
+/**
+ * A small work-stealing thread pool for the parallel sorting algorithms.
+ *
+ * Every worker owns a task deque. Tasks submitted from inside a worker go to
+ * the back of its own deque and are taken back LIFO, which keeps recursive
+ * fork/join algorithms cache friendly; idle workers steal from the front of the
+ * other deques, where the oldest (and usually biggest) tasks are.
+ * @date July 5th, 2021
+ * @file thread_pool.h
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>            // std::max
+#include <atomic>               // std::atomic
+#include <condition_variable>   // std::condition_variable
+#include <cstddef>              // std::size_t
+#include <deque>                // std::deque
+#include <exception>            // std::exception_ptr
+#include <functional>           // std::function
+#include <map>                  // std::map
+#include <memory>               // std::unique_ptr
+#include <mutex>                // std::mutex
+#include <thread>               // std::thread
+#include <vector>               // std::vector
+
+namespace sa { // sa = sorting algorithms
+
+    /// Fixed-size work-stealing thread pool.
+    class thread_pool {
+        public:
+            using task_type = std::function<void()>;
+
+            /// Starts `n_threads` workers (at least one).
+            explicit thread_pool(unsigned n_threads) : m_stop{false}, m_pending{0}, m_next{0} {
+                n_threads = std::max(1u, n_threads);
+                for(unsigned i = 0; i < n_threads; i++) m_queues.emplace_back(new queue);
+                for(unsigned i = 0; i < n_threads; i++) m_workers.emplace_back([this, i]{ work(i); });
+            }
+
+            /// Finishes the queued tasks and joins the workers.
+            ~thread_pool(){
+                {
+                    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                    m_stop = true;
+                }
+                m_sleep_cv.notify_all();
+                for(auto &w : m_workers) w.join();
+            }
+
+            thread_pool(const thread_pool &) = delete;
+            thread_pool & operator=(const thread_pool &) = delete;
+
+            /// Number of workers.
+            unsigned size(void) const { return static_cast<unsigned>(m_workers.size()); }
+
+            /// Queues `task`: on the calling worker's own deque, or round-robin when called from outside the pool.
+            void submit(task_type task){
+                std::size_t i = current().pool == this ? current().index
+                                                       : m_next++ % m_queues.size();
+                m_pending++;
+                {
+                    std::lock_guard<std::mutex> lock(m_queues[i]->mutex);
+                    m_queues[i]->tasks.push_back(std::move(task));
+                }
+                // taking the lock orders this notify after a worker's last check of m_pending.
+                { std::lock_guard<std::mutex> lock(m_sleep_mutex); }
+                m_sleep_cv.notify_one();
+            }
+
+            /*!
+             * Runs one queued task on the calling thread, if there is any.
+             *
+             * A worker first takes the newest task of its own deque, then steals the
+             * oldest task of the others; an outside thread only steals.
+             * @return true if a task was run.
+             */
+            bool run_one(void){
+                std::size_t n = m_queues.size();
+                bool inside = current().pool == this;
+                std::size_t self = inside ? current().index : 0;
+                task_type task;
+                for(std::size_t k = 0; k < n && !task; k++) {
+                    std::size_t i = (self + k) % n;
+                    queue &q = *m_queues[i];
+                    std::lock_guard<std::mutex> lock(q.mutex);
+                    if(q.tasks.empty()) continue;
+                    if(inside && k == 0) { task = std::move(q.tasks.back()); q.tasks.pop_back(); }
+                    else { task = std::move(q.tasks.front()); q.tasks.pop_front(); }
+                }
+                if(!task) return false;
+                m_pending--;
+                task();
+                return true;
+            }
+
+            /// Keeps running queued tasks on the calling thread until `done()` holds.
+            template< typename Predicate >
+            void wait_until(Predicate done){
+                while(!done())
+                    if(!run_one()) std::this_thread::yield();
+            }
+
+            /// Pool shared by the parallel algorithms: one worker per hardware thread, minus the caller's.
+            static thread_pool & shared(void){
+                static thread_pool pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+                return pool;
+            }
+
+            /*!
+             * Pool with `n_workers` workers (at least one), started on first use and kept
+             * until the program ends, so that repeated calls do not pay for creating and
+             * joining threads.
+             */
+            static thread_pool & with_workers(unsigned n_workers){
+                static std::mutex mutex;
+                static std::map<unsigned, std::unique_ptr<thread_pool>> pools;
+                n_workers = std::max(1u, n_workers);
+                std::lock_guard<std::mutex> lock(mutex);
+                auto &pool = pools[n_workers];
+                if(!pool) pool.reset(new thread_pool(n_workers));
+                return *pool;
+            }
+
+        private:
+            /// A worker's deque.
+            struct queue {
+                std::mutex mutex;
+                std::deque<task_type> tasks;
+            };
+
+            /// Which pool, and which worker of it, the current thread is.
+            struct worker_id {
+                thread_pool *pool{nullptr};
+                std::size_t index{0};
+            };
+
+            std::vector<std::unique_ptr<queue>> m_queues;  //!< One deque per worker.
+            std::vector<std::thread> m_workers;            //!< The worker threads.
+            std::mutex m_sleep_mutex;                      //!< Protects m_stop; idle workers sleep on it.
+            std::condition_variable m_sleep_cv;            //!< Signals new tasks or shutdown.
+            bool m_stop;                                   //!< Set when the pool is being destroyed.
+            std::atomic<std::size_t> m_pending;            //!< Tasks queued and not yet taken.
+            std::atomic<std::size_t> m_next;               //!< Round-robin target for outside submissions.
+
+            static worker_id & current(void){
+                thread_local worker_id id;
+                return id;
+            }
+
+            /// Body of every worker: runs tasks, sleeping while there are none, until the pool stops.
+            void work(std::size_t index){
+                current() = { this, index };
+                while(true) {
+                    if(run_one()) continue;
+                    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+                    m_sleep_cv.wait(lock, [this]{ return m_stop || m_pending > 0; });
+                    if(m_stop && m_pending == 0) return;
+                }
+            }
+    };
+
+    /*!
+     * A set of tasks that run on a thread_pool and are waited for together.
+     *
+     * Tasks may add more tasks to the same group. wait() does not block the calling
+     * thread: it helps running queued tasks until every task of the group is done,
+     * so nested fork/join levels never starve the pool. The first exception thrown
+     * by a task is rethrown by wait().
+     */
+    class task_group {
+        public:
+            explicit task_group(thread_pool &pool) : m_pool(pool), m_running{0} {}
+            task_group(const task_group &) = delete;
+            task_group & operator=(const task_group &) = delete;
+            ~task_group(){ m_pool.wait_until([this]{ return m_running == 0; }); }
+
+            /// Queues `fn` on the pool as part of this group.
+            template< typename Fn >
+            void run(Fn fn){
+                m_running++;
+                m_pool.submit([this, fn]() mutable {
+                    try { fn(); }
+                    catch(...) {
+                        std::lock_guard<std::mutex> lock(m_error_mutex);
+                        if(!m_error) m_error = std::current_exception();
+                    }
+                    m_running--;
+                });
+            }
+
+            /// Returns once every task of the group has finished.
+            void wait(void){
+                m_pool.wait_until([this]{ return m_running == 0; });
+                if(m_error) std::rethrow_exception(m_error);
+            }
+
+        private:
+            thread_pool &m_pool;
+            std::atomic<std::size_t> m_running;  //!< Tasks queued or running.
+            std::mutex m_error_mutex;
+            std::exception_ptr m_error;
+    };
+}
+
+#endif // THREAD_POOL_H
@@ -1,6 +1,45 @@
 /*!
  * @file main.cpp
  * Benchmarking suit to compare sorting algorithms under various situations.
+ *
+ * Usage: sortsuite [options]
+ *   --algos A,B,...     algorithms to run (default: all of them)
+ *   --dists D,E,...     input distributions (default: all of them)
+ *   --min N             smallest input size (default 100)
+ *   --max N             largest input size (default 100000)
+ *   --scale S           linear or geometric size steps (default linear)
+ *   --step X            size increment (linear) or factor (geometric)
+ *   --samples N         number of sizes, used when --step is not given (default 25)
+ *   --runs N            timed runs per algorithm and size (default 5)
+ *   --seed N            seed of the input generator (default 2021)
+ *   --quadratic-max N   largest size for the O(n^2) algorithms, and for the quick sorts with
+ *                       a two-way partition on LOW_CARDINALITY (default 50000)
+ *   --threads N         threads of the parallel sorts, 0 for all (default 0)
+ *   --cutoff N          sequential cutoff of the parallel sorts (default 16384)
+ *   --topk N            runs the top-k scenario on N elements (default 0: skipped; 10000000 is a good size)
+ *   --format F          csv or json (default csv)
+ *   --out DIR           directory of the DATASET files (default data/)
+ *   --type T            element type: int, string (24 characters, heap allocated),
+ *                       record or record256 (128 or 256-byte struct with an int key) (default int)
+ *   --counters          also records hardware counters of every run (Linux perf_event_open)
+ *   --count             also counts the comparisons, swaps, moves, copies and allocations
+ *                       of every algorithm, in one extra, untimed run
+ *   --list              prints the algorithms (of --type) and distributions and exits
+ *
+ * One DATASET file is written per distribution, with one line per size and
+ * algorithm holding the min, median, p99 and mean of the runs, in milliseconds.
+ * With --counters, every line also holds the median cycles, instructions, branch
+ * misses and cache misses of the runs, and these per element (IPC for the
+ * instructions); a counter the machine does not provide is left empty, and if none
+ * is available a warning is printed and only the times are written. The counters
+ * see the calling thread only, so they are left empty for the parallel sorts.
+ * With --count, every line also holds the operation counts of the algorithm, and
+ * the comparisons, swaps and moves per element; they are left empty for the radix
+ * sorts, which only work on the plain integers.
+ * Every run is checked to leave its range sorted.
+ * Past --quadratic-max, QUICK, QUICK_BLOCK and QUICK_NET are skipped on LOW_CARDINALITY,
+ * where they are quadratic; the progress line marks them as skipped and no DATASET
+ * line is written for them.
  */
 
 #include <iostream>
@@ -16,195 +55,635 @@
 using std::function;
 using std::cout;
 #include "lib/sorting.h"
+#include "lib/perf_counters.h"
 #include <numeric>
 #include <random>
-#include <time.h>  
-#include <cstdlib> 
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <cctype>
 
 //=== ALIASES
 
-/// Data type we are working with.
-using value_type = long int;
 /// Size type.
 using size_type = long int;
 /// Alias for duration measure.
 using duration_t = std::chrono::duration<double, std::milli>;
+/// Iterator to the ranges we sort.
+template< typename T >
+using iterator = typename std::vector<T>::iterator;
 
+/// A heavy record: an int key and a payload that makes it `Bytes` bytes long.
+template< std::size_t Bytes >
+struct BasicRecord{
+    int key;
+    char payload[Bytes - sizeof(int)];
+    bool operator<(const BasicRecord &other) const { return key < other.key; }
+};
+using Record = BasicRecord<128>;
+using Record256 = BasicRecord<256>;
+static_assert(sizeof(Record) == 128 && sizeof(Record256) == 256, "Records should be 128 and 256 bytes long");
+
+/// Whether T is one of the records.
+template< typename T > struct is_record : std::false_type {};
+template< std::size_t Bytes > struct is_record<BasicRecord<Bytes>> : std::true_type {};
+
+/// The element type T stands for: T itself, or the value wrapped by an sa::counted.
+template< typename T > struct plain { using type = T; };
+template< typename T > struct plain<sa::counted<T>> { using type = T; };
+template< typename T > using plain_t = typename plain<T>::type;
+
+/// Integer key of an int, a record or a counted one of them.
+inline int sort_key(int value){ return value; }
+template< std::size_t Bytes >
+int sort_key(const BasicRecord<Bytes> &r){ return r.key; }
+template< typename T >
+int sort_key(const sa::counted<T> &value){ return sort_key(value.get()); }
+
+/// Command line options.
 struct RunningOpt{
-    size_t min_sample_sz{100};   //!< Default 10^5. 100
-    size_t max_sample_sz{100000}; //!< The max sample size. 100000 
-    int n_samples{25};            //!< The number of samples to collect.
+    std::vector<std::string> algos;     //!< Algorithms to run; empty means all.
+    std::vector<std::string> dists;     //!< Distributions to run; empty means all.
+    size_type min_sample_sz{100};       //!< The min sample size.
+    size_type max_sample_sz{100000};    //!< The max sample size.
+    bool geometric{false};              //!< Whether the sizes grow geometrically instead of linearly.
+    double step{0};                     //!< Size increment (linear) or factor (geometric); 0 derives it from n_samples.
+    int n_samples{25};                  //!< The number of sizes, when no step is given.
+    int n_runs{5};                      //!< Timed runs per algorithm and size.
+    unsigned seed{2021};                //!< Seed of the input generator.
+    size_type quadratic_max{50000};     //!< Quadratic algorithms are skipped past this size.
+    sa::parallel_options parallel;      //!< Thread count and cutoff of the parallel sorts.
+    size_type topk_size{0};             //!< Size of the top-k scenario; 0 (the default) skips it.
+    std::string format{"csv"};          //!< Output format, csv or json.
+    std::string path{"data/"};          //!< Directory of the DATASET files.
+    std::string type{"int"};            //!< Element type: int, string, record or record256.
+    bool counters{false};               //!< Whether to record hardware counters.
+    bool count{false};                  //!< Whether to count the operations of every algorithm.
+
     /// Returns the sample size step, based on the [min,max] sample sizes and # of samples.
-    size_type sample_step(void){
-        return static_cast<float>(max_sample_sz-min_sample_sz)/(n_samples-1);
+    double sample_step(void) const {
+        if(step > 0) return step;
+        if(n_samples < 2) return geometric ? 2 : max_sample_sz;
+        if(geometric) return std::pow(static_cast<double>(max_sample_sz)/min_sample_sz, 1.0/(n_samples-1));
+        return std::max(1.0, static_cast<double>(max_sample_sz-min_sample_sz)/(n_samples-1));
+    }
+
+    /// Returns the sizes to run, from min_sample_sz to max_sample_sz.
+    std::vector<size_type> sizes(void) const {
+        std::vector<size_type> result;
+        double s = sample_step();
+        for(double size = min_sample_sz; size <= max_sample_sz + 0.5; size = geometric ? size * s : size + s){
+            auto rounded = static_cast<size_type>(std::llround(size));
+            if(result.empty() || rounded != result.back()) result.push_back(rounded);
+            if(geometric && s <= 1) break;
+        }
+        return result;
     }
 };
 
-//=== CONSTANT DEFINITIONS.
+/// A sorting algorithm of the suite, for elements of type T.
+template< typename T >
+struct Algorithm{
+    std::string name;                               //!< Column name in the DATASET files.
+    bool quadratic;                                 //!< Whether it is O(n^2), and so limited by the size budget.
+    function<void(iterator<T>, iterator<T>)> sort;  //!< Sorts [first;last).
+    bool parallel{false};                           //!< Whether it sorts on the thread pool, out of sight of the counters.
+    bool quadratic_on_few_keys{false};              //!< Whether it is O(n^2) on few distinct keys, and so limited by the size budget there.
+};
+
+/// An input distribution of the suite.
+struct Distribution{
+    std::string name;                               //!< Name of its DATASET file.
+    function<void(std::vector<int>&, std::mt19937&)> shape; //!< Reorders (or remaps) 1, 2, ..., n.
+    bool few_keys{false};                           //!< Whether it has only LOW_CARDINALITY distinct keys.
+};
 
-/// Number of runs we need to calculate the average runtime for a single algorithm.
-constexpr short N_RUNS = 5;
+/// Statistics of the runs of one algorithm on one input, in milliseconds.
+struct Stats{
+    double min{0}, median{0}, p99{0}, mean{0};
+    sa::perf_sample counters;           //!< Median hardware counters of the runs, -1 where not recorded.
+    bool counted{false};                //!< Whether `counts` was recorded.
+    sa::operation_counts counts;        //!< Operations of one run on sa::counted elements.
+};
 
-//Seed used to random the numbers when creating the vector
-const int SEED = rand()%100;
+//=== CONSTANT DEFINITIONS.
 
-//Path where you want to save the DATASET files
-const string PATH = "data/";
+//Number of distinct keys in the low cardinality vectors
+constexpr int LOW_CARDINALITY = 16;
 
-//Last digits of the DATASET file
-const string FILE_FORMAT = ".txt";
+//Largest slice the *_NET algorithms hand to their sorting network base case
+constexpr std::ptrdiff_t NETWORK_CUTOFF = 16;
 
 /// Comparison function for the test experiment.
-constexpr bool compare( const int&a, const int &b ){
+template< typename T >
+constexpr bool compare( const T&a, const T &b ){
     return ( a < b );
 }
 
+/// Comparator the algorithms get for elements of type T: compare<T>, counting its calls on sa::counted elements.
+template< typename T >
+auto comparator(void){
+    if constexpr (sa::is_counted<T>::value) return sa::make_counting_compare(compare<T>);
+    else return compare<T>;
+}
+
+/**
+ * Comparator of the *_NET algorithms: std::less<T>, which orders like compare<T> and is what
+ * sa::small_sort() needs to pick a sorting network; its calls are counted likewise.
+ */
+template< typename T >
+auto network_comparator(void){
+    if constexpr (sa::is_counted<T>::value) return sa::make_counting_compare(std::less<T>{});
+    else return std::less<T>{};
+}
+
 //=== AUXILIAR FUNCTIONS.
 
+/// Returns every algorithm of the suite that can sort elements of type T.
+template< typename T >
+std::vector<Algorithm<T>> algorithms(const RunningOpt &opt){
+    using It = iterator<T>;
+    auto parallel = opt.parallel;
+    auto cmp = comparator<T>();
+    auto less = network_comparator<T>();
+    std::vector<Algorithm<T>> algos {
+        {"INSERTION", true, [cmp](It f, It l){ sa::insertion(f, l, cmp); }},
+        {"SELECTION", true, [cmp](It f, It l){ sa::selection(f, l, cmp); }},
+        {"BUBBLE", true, [cmp](It f, It l){ sa::bubble(f, l, cmp); }},
+        {"SHELL", false, [cmp](It f, It l){ sa::shell(f, l, cmp); }},
+        // the two-way partitions put every key equal to the pivot on one side: quadratic on few keys.
+        {"QUICK", false, [cmp](It f, It l){ sa::quick(f, l, cmp); }, false, true},
+        {"QUICK_BLOCK", false, [cmp](It f, It l){ sa::quick(f, l, cmp, sa::partition_scheme::block); }, false, true},
+        {"MERGE", false, [cmp](It f, It l){ sa::mergesort(f, l, cmp); }},
+        {"QUICK_NET", false, [less](It f, It l){ sa::quick(f, l, less, sa::partition_scheme::lomuto, NETWORK_CUTOFF); }, false, true},
+        {"MERGE_NET", false, [less](It f, It l){ sa::mergesort(f, l, less, NETWORK_CUTOFF); }},
+    };
+    // the radix sorts work on the bits of integer keys.
+    if constexpr (std::is_same<T, int>::value)
+        algos.push_back({"RADIX", false, [](It f, It l){ sa::radix(f, l); }});
+    std::vector<Algorithm<T>> more {
+        {"INTROSORT", false, [cmp](It f, It l){ sa::introsort(f, l, cmp); }},
+        {"QUICK3", false, [cmp](It f, It l){ sa::quick3(f, l, cmp); }},
+        {"MERGE_BUF", false, [cmp](It f, It l){ sa::mergesort_buffered(f, l, cmp); }},
+        {"PAR_MERGE", false, [cmp, parallel](It f, It l){ sa::parallel_mergesort(f, l, cmp, parallel); }, true},
+        {"PAR_QUICK", false, [cmp, parallel](It f, It l){ sa::parallel_quick(f, l, cmp, parallel); }, true},
+    };
+    algos.insert(algos.end(), more.begin(), more.end());
+    if constexpr (std::is_same<T, int>::value){
+        algos.push_back({"RADIX_LSD", false, [](It f, It l){ sa::radix_lsd(f, l); }});
+        algos.push_back({"AMERICAN_FLAG", false, [](It f, It l){ sa::american_flag(f, l); }});
+    }
+    if constexpr (is_record<plain_t<T>>::value || std::is_same<T, sa::counted<int>>::value)
+        algos.push_back({"AMERICAN_FLAG", false, [](It f, It l){ sa::american_flag(f, l, [](const T &r){ return sort_key(r); }); }});
+    algos.push_back({"TIMSORT", false, [cmp](It f, It l){ sa::timsort(f, l, cmp); }});
+    algos.push_back({"HEAPSORT", false, [cmp](It f, It l){ sa::heapsort(f, l, cmp); }});
+    // heavy elements: sort indices, or (key, index) pairs, then move every element once.
+    if constexpr (!std::is_same<plain_t<T>, int>::value)
+        algos.push_back({"INDIRECT", false, [cmp](It f, It l){ sa::indirect_sort(f, l, cmp); }});
+    if constexpr (is_record<plain_t<T>>::value)
+        algos.push_back({"BY_KEY", false, [](It f, It l){ sa::sort_by_key(f, l, [](const T &r){ return sort_key(r); }); }});
+    return algos;
+}
+
+/// Returns every input distribution of the suite.
+std::vector<Distribution> distributions(){
+    return {
+        {"ASCENDING_ORDER", [](std::vector<int> &, std::mt19937 &){}},
+        {"DESCENDING_ORDER", [](std::vector<int> &set, std::mt19937 &){ std::reverse(set.begin(), set.end()); }},
+        {"75_RANDOM", [](std::vector<int> &set, std::mt19937 &gen){ std::shuffle(set.begin() + set.size()/4, set.end(), gen); }},
+        {"50_RANDOM", [](std::vector<int> &set, std::mt19937 &gen){ std::shuffle(set.begin() + 2*set.size()/4, set.end(), gen); }},
+        {"25_RANDOM", [](std::vector<int> &set, std::mt19937 &gen){ std::shuffle(set.begin() + 3*set.size()/4, set.end(), gen); }},
+        {"ALL_RANDOM", [](std::vector<int> &set, std::mt19937 &gen){ std::shuffle(set.begin(), set.end(), gen); }},
+        {"LOW_CARDINALITY", [](std::vector<int> &set, std::mt19937 &gen){
+            std::shuffle(set.begin(), set.end(), gen);
+            for(auto &value : set) value = 1 + value % LOW_CARDINALITY;
+        }, true},
+    };
+}
+
+/// Builds the element of type T with the given key; elements compare like their keys.
+template< typename T >
+T make_value(int key);
+
+template<>
+int make_value<int>(int key){ return key; }
+
+template<>
+std::string make_value<std::string>(int key){
+    // 24 characters: too long for the small string buffer, so every string owns heap memory.
+    std::ostringstream oss;
+    oss << "sortsuite-key-" << std::setw(10) << std::setfill('0') << key;
+    return oss.str();
+}
+
+template<>
+Record make_value<Record>(int key){
+    Record r;
+    r.key = key;
+    std::fill(std::begin(r.payload), std::end(r.payload), static_cast<char>(key));
+    return r;
+}
+
+template<>
+Record256 make_value<Record256>(int key){
+    Record256 r;
+    r.key = key;
+    std::fill(std::begin(r.payload), std::end(r.payload), static_cast<char>(key));
+    return r;
+}
+
+/// Suffix of the DATASET files of elements of type T.
+template< typename T >
+std::string type_suffix(void){
+    if(std::is_same<T, std::string>::value) return "_STRING";
+    if(std::is_same<T, Record>::value) return "_RECORD";
+    if(std::is_same<T, Record256>::value) return "_RECORD256";
+    return "";
+}
+
 /**
- * @brief Recieves a size and the type of the vector and return the vector
- * 
- * @param i Determine the type of the vector (ascending,descending, 25% order....,all random)
+ * @brief Builds the input vector of a distribution
+ *
+ * @param dist The distribution (ascending,descending, 25% order....,all random, low cardinality)
  * @param size Determine the vector size
- * @return std::vector<int> 
+ * @param seed Seed of the generator, so that the same input is built on every execution
+ * @return std::vector<T>
  */
-std::vector<int> set_vector(size_t i, size_type size){
-    std::vector<int> set(size);
-    std::iota(set.begin(), set.end(), 1); // Fill with 0, 1, ..., 99, 100, .....
-    switch (i){
-        case 0: //Ascending order
-            return set;
-        case 1: //Descending order
-            std::reverse(set.begin(),set.end());
-            return set;
-        case 2: //75% random
-            std::shuffle(set.begin() + size/4, set.end(),std::default_random_engine(SEED));
-            return set;
-        case 3: //50% random
-            std::shuffle(set.begin() + (2*size/4), set.end(),std::default_random_engine(SEED));
-            return set;
-        case 4: //25% random
-            std::shuffle(set.begin() + (3*size/4), set.end(),std::default_random_engine(SEED));
-            return set;
-        case 5: //All random
-            std::shuffle(set.begin(), set.end(),std::default_random_engine(SEED));
-            return set;
+template< typename T >
+std::vector<T> set_vector(const Distribution &dist, size_type size, unsigned seed){
+    std::vector<int> keys(size);
+    std::iota(keys.begin(), keys.end(), 1); // Fill with 1, 2, ..., 99, 100, .....
+    std::mt19937 gen(seed);
+    dist.shape(keys, gen);
+    std::vector<T> set;
+    set.reserve(size);
+    for(int key : keys) set.push_back(make_value<T>(key));
+    return set;
+}
+
+/// Splits a comma separated list.
+std::vector<std::string> split(const std::string &list){
+    std::vector<std::string> items;
+    std::istringstream iss{list};
+    std::string item;
+    while(std::getline(iss, item, ',')) if(!item.empty()) items.push_back(item);
+    return items;
+}
+
+/// Whether `name` was selected by a --algos/--dists list (an empty list selects everything).
+bool selected(const std::vector<std::string> &list, const std::string &name){
+    return list.empty() || std::find(list.begin(), list.end(), name) != list.end();
+}
+
+/// Prints the usage message and exits with `status`.
+void usage(int status){
+    (status == EXIT_SUCCESS ? cout : std::cerr)
+        << "Usage: sortsuite [--algos A,B] [--dists D,E] [--min N] [--max N] [--scale linear|geometric]\n"
+        << "                 [--step X] [--samples N] [--runs N] [--seed N] [--quadratic-max N]\n"
+        << "                 [--threads N] [--cutoff N] [--topk N] [--format csv|json] [--out DIR]\n"
+        << "                 [--type int|string|record|record256] [--counters] [--count] [--list]\n";
+    std::exit(status);
+}
+
+/// Names of the algorithms that can sort elements of type T, marking the quadratic ones if `mark`.
+template< typename T >
+std::vector<std::string> algorithm_names(const RunningOpt &opt, bool mark){
+    std::vector<std::string> names;
+    for(auto &algo : algorithms<T>(opt)) names.push_back(algo.name + (mark && algo.quadratic ? "(quadratic)" : ""));
+    return names;
+}
+
+/// Names of the algorithms that can sort elements of the type chosen with --type.
+std::vector<std::string> algorithm_names(const RunningOpt &opt, bool mark = false){
+    if(opt.type == "string") return algorithm_names<std::string>(opt, mark);
+    if(opt.type == "record") return algorithm_names<Record>(opt, mark);
+    if(opt.type == "record256") return algorithm_names<Record256>(opt, mark);
+    return algorithm_names<int>(opt, mark);
+}
+
+/// Parses the command line, exiting with a message on invalid input.
+RunningOpt parse(int argc, char *argv[]){
+    RunningOpt opt;
+    bool list = false;
+    for(int i = 1; i < argc; i++){
+        std::string arg{argv[i]};
+        if(arg == "--help") usage(EXIT_SUCCESS);
+        if(arg == "--list"){ list = true; continue; }
+        if(arg == "--counters"){ opt.counters = true; continue; }
+        if(arg == "--count"){ opt.count = true; continue; }
+        if(i + 1 >= argc){ std::cerr << "Missing value for " << arg << "\n"; usage(EXIT_FAILURE); }
+        std::string value{argv[++i]};
+        try{
+            if(arg == "--algos") opt.algos = split(value);
+            else if(arg == "--dists") opt.dists = split(value);
+            else if(arg == "--min") opt.min_sample_sz = std::stol(value);
+            else if(arg == "--max") opt.max_sample_sz = std::stol(value);
+            else if(arg == "--scale") opt.geometric = (value == "geometric");
+            else if(arg == "--step") opt.step = std::stod(value);
+            else if(arg == "--samples") opt.n_samples = std::stoi(value);
+            else if(arg == "--runs") opt.n_runs = std::stoi(value);
+            else if(arg == "--seed") opt.seed = static_cast<unsigned>(std::stoul(value));
+            else if(arg == "--quadratic-max") opt.quadratic_max = std::stol(value);
+            else if(arg == "--threads") opt.parallel.threads = static_cast<unsigned>(std::stoul(value));
+            else if(arg == "--cutoff") opt.parallel.cutoff = std::stol(value);
+            else if(arg == "--topk") opt.topk_size = std::stol(value);
+            else if(arg == "--format") opt.format = value;
+            else if(arg == "--type") opt.type = value;
+            else if(arg == "--out") opt.path = value.empty() || value.back() == '/' ? value : value + "/";
+            else{ std::cerr << "Unknown option " << arg << "\n"; usage(EXIT_FAILURE); }
+            if(arg == "--scale" && value != "linear" && value != "geometric"){ std::cerr << "Invalid scale " << value << "\n"; usage(EXIT_FAILURE); }
+        }
+        catch(const std::exception &){
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            usage(EXIT_FAILURE);
         }
-        return set;
     }
+    if(opt.min_sample_sz < 1 || opt.max_sample_sz < opt.min_sample_sz || opt.n_runs < 1
+            || (opt.format != "csv" && opt.format != "json")
+            || (opt.type != "int" && opt.type != "string" && opt.type != "record" && opt.type != "record256")
+            || (opt.step != 0 && opt.geometric && opt.step <= 1) || opt.step < 0){
+        std::cerr << "Invalid options: need 1 <= --min <= --max, --runs >= 1, --format csv or json, a geometric --step > 1 and --type int, string, record or record256.\n";
+        usage(EXIT_FAILURE);
+    }
+    if(list){
+        cout << "Algorithms:";
+        for(auto &name : algorithm_names(opt, true)) cout << " " << name;
+        cout << "\nDistributions:";
+        for(auto &dist : distributions()) cout << " " << dist.name;
+        cout << "\n";
+        std::exit(EXIT_SUCCESS);
+    }
+    for(auto &name : opt.algos){
+        auto all = algorithm_names(opt);
+        if(std::find(all.begin(), all.end(), name) == all.end()){
+            std::cerr << "Unknown algorithm " << name << " for --type " << opt.type << " (see --list)\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    for(auto &name : opt.dists){
+        auto all = distributions();
+        if(std::none_of(all.begin(), all.end(), [&](const Distribution &d){ return d.name == name; })){
+            std::cerr << "Unknown distribution " << name << " (see --list)\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    return opt;
+}
+
+/// Computes the statistics of the run times (which get sorted).
+Stats summarize(std::vector<double> &times){
+    Stats s;
+    std::sort(times.begin(), times.end());
+    auto n = times.size();
+    // nearest-rank percentile.
+    auto percentile = [&](double p){ return times[std::min(n - 1, static_cast<size_t>(std::ceil(p * n)) - 1)]; };
+    s.min = times.front();
+    s.median = n % 2 ? times[n/2] : (times[n/2 - 1] + times[n/2]) / 2;
+    s.p99 = percentile(0.99);
+    s.mean = std::accumulate(times.begin(), times.end(), 0.0) / n;
+    return s;
+}
+
+/// Median of each counter of the samples, -1 where a counter was not recorded.
+sa::perf_sample median_counters(const std::vector<sa::perf_sample> &samples){
+    sa::perf_sample median;
+    for(int c = 0; c < sa::perf_sample::N_COUNTERS; c++){
+        std::vector<std::int64_t> values;
+        for(auto &sample : samples) if(sample.value[c] >= 0) values.push_back(sample.value[c]);
+        if(values.empty()) continue;
+        std::nth_element(values.begin(), values.begin() + values.size()/2, values.end());
+        median.value[c] = values[values.size()/2];
+    }
+    return median;
+}
 
 /**
- * @brief This function recieves an array and the identifier of the algorithm and return the duration to run it, in milliseconds
- * @param first First element of the array, the interval is [first,last)
- * @param last Next element after the last element, the interval is [first,last)
- * @param cmp This function is used for compare the valeus of the vector
- * @param sorting_type determine what sorting algorithm will be used (inserction sort, selection sort, bubble sort, ..., radix sort)
- * @return Return the duration of an specific sorting algorithm using a vector
+ * @brief Runs `sort` opt.n_runs times, each on a fresh copy of `input`, and checks that every run sorts it
+ * @param perf The hardware counters to record around every run, or nullptr
+ * @return The statistics of the run times, in milliseconds, and the median counters
  */
-template< typename RandomIt, typename Compare >
-duration_t time_algorithm(RandomIt first, RandomIt last, Compare cmp, size_t sorting_type){
-    duration_t diff;
-    std::chrono::time_point<std::chrono::steady_clock> end,start;
-    switch (sorting_type){
-    case 0:
-        start = std::chrono::steady_clock::now();
-        sa::insertion(first, last,cmp);
-        end = std::chrono::steady_clock::now();
-        diff = end - start;
-        return diff; 
-    case 1:
-        start = std::chrono::steady_clock::now();
-        sa::selection(first, last,cmp);
-        end = std::chrono::steady_clock::now();
-        diff = end - start;
-        return diff;
-    case 2:
-        start = std::chrono::steady_clock::now();
-        sa::bubble(first, last,cmp);
-        end = std::chrono::steady_clock::now();
-        diff = end - start;
-        return diff; 
-    case 3:
-        start = std::chrono::steady_clock::now();
-        sa::shell(first, last,cmp);
-        end = std::chrono::steady_clock::now();
-        diff = end - start;
-        return diff;
-    case 4:
-        start = std::chrono::steady_clock::now();
-        sa::quick(first, last,cmp);
-        end = std::chrono::steady_clock::now();
-        diff = end - start;
-        return diff; 
-    case 5:
-        start = std::chrono::steady_clock::now();
-        sa::mergesort(first, last,cmp);
-        end = std::chrono::steady_clock::now();
-        diff = end - start;
-        return diff;
-    case 6:
-        start = std::chrono::steady_clock::now();
-        sa::radix(first, last);
-        end = std::chrono::steady_clock::now();
-        diff = end - start;
-        return diff;
-    }   
-    start = std::chrono::steady_clock::now();
-    end = std::chrono::steady_clock::now();
-    diff = end - start;
-    return diff;   
+template< typename T >
+Stats time_algorithm(const Algorithm<T> &algo, const std::vector<T> &input, const RunningOpt &opt, sa::perf_counters *perf){
+    std::vector<double> times;
+    std::vector<sa::perf_sample> samples;
+    std::vector<T> copy;
+    for(int ct_run = 1; ct_run <= opt.n_runs; ct_run++){
+        copy = input;
+        if(perf) perf->start();
+        auto start = std::chrono::steady_clock::now();
+        algo.sort(copy.begin(), copy.end());
+        auto end = std::chrono::steady_clock::now();
+        if(perf) samples.push_back(perf->stop());
+        times.push_back(duration_t(end - start).count());
+        if(!std::is_sorted(copy.begin(), copy.end(), compare<T>)){
+            std::cerr << "\nERROR: " << algo.name << " did not sort an input of size " << input.size() << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    Stats s = summarize(times);
+    if(perf) s.counters = median_counters(samples);
+    return s;
 }
 
-//=== The main function, entry point.
-int main()
-{
-    std::chrono::time_point<std::chrono::steady_clock> end,start; //REMOVE
-    duration_t coisa;
-    duration_t time_mean;
-    RunningOpt info;
-    //Names of the dataset columns
-    std::vector<std::string> names {"INSERTION", "SELECTION", "BUBBLE", "SHELL","QUICK","MERGE","RADIX"};
-    std::vector<std::string> files {"ASCENDING_ORDER", "DESCENDING_ORDER", "75_RANDOM", "50_RANDOM", "25_RANDOM" , "ALL_RANDOM"};
-    
-    //Loop to each type of vector organization
-    for(size_t ifile = 0; ifile < files.size(); ifile++){
-        std::ofstream DATASET(PATH+files[ifile]+ FILE_FORMAT); //INITIALIZE FILE
-        DATASET << "SIZE" ;
-        //Print columns names
-        for(size_t i =0 ;i < names.size(); i++){
-        DATASET << "," << names[i] ;
+/**
+ * @brief Runs `sort` once on a copy of `input`, counting its operations, and checks that it sorts it
+ * @return The comparisons, swaps, moves, copies and allocations of the run
+ */
+template< typename T >
+sa::operation_counts count_operations(const Algorithm<sa::counted<T>> &algo, const std::vector<sa::counted<T>> &input){
+    std::vector<sa::counted<T>> copy = input;
+    sa::reset_counts();
+    algo.sort(copy.begin(), copy.end());
+    sa::operation_counts counts = sa::read_counts();
+    if(!std::is_sorted(copy.begin(), copy.end(), compare<sa::counted<T>>)){
+        std::cerr << "\nERROR: " << algo.name << " did not sort an input of size " << input.size() << " of counted elements\n";
+        std::exit(EXIT_FAILURE);
+    }
+    return counts;
+}
+
+/// Writes the DATASET file of one distribution.
+class Dataset{
+    public:
+        /*!
+         * With `counters`, every line also gets the hardware counters of Stats and the metrics derived
+         * from them; with `counts`, the operation counts of Stats and the metrics derived from them.
+         */
+        Dataset(const std::string &file, bool json, bool counters = false, bool counts = false)
+            : m_out(file), m_json(json), m_counters(counters), m_counts(counts), m_first(true){
+            if(!m_out) std::cerr << "Cannot write " << file << "\n";
+            if(m_json) m_out << "[\n";
+            else{
+                m_out << "SIZE,ALGORITHM,RUNS,MIN,MEDIAN,P99,MEAN";
+                for(auto &column : extra_columns(0, Stats{})) m_out << "," << column.first;
+                m_out << "\n";
+            }
         }
-        DATASET << std::endl;
-
-        //Copy of last work
-            //This for loop pass step by step
-            for(size_type size = info.min_sample_sz; 
-                        size <= info.max_sample_sz;
-                        size += info.sample_step()){
-                std::vector<int> arr_test = set_vector(ifile, size); 
-                vector<int> copy = arr_test; 
-                cout << " Type:["<< files[ifile] << "] Size:[" << size << "/" <<info.max_sample_sz << "] Algorithm(ms): ";
-                //Pass by diferents algorithms
-                for(size_t algo_type =0; algo_type < names.size(); algo_type++){
-                    cout << "["  <<names[algo_type] << ","; 
-                    //Repeat the same vector and calculate the mean
-                    time_mean = std::chrono::milliseconds::zero();
-                    DATASET << size; 
-                    for(int ct_run = 1; ct_run <= N_RUNS; ct_run++){
-                        duration_t diff = time_algorithm(copy.begin(), copy.end(),compare,algo_type);
-                        time_mean = time_mean + (diff - time_mean)/ct_run;    
-                        copy = arr_test;
-                    }
-                    DATASET <<  "," << time_mean.count();  
-                    cout << time_mean.count() << "]"; 
+        ~Dataset(){ if(m_json) m_out << "\n]\n"; }
+        void write(size_type size, const std::string &algo, int runs, const Stats &s){
+            if(m_json){
+                m_out << (m_first ? "" : ",\n") << "  { \"size\": " << size << ", \"algorithm\": \"" << algo
+                      << "\", \"runs\": " << runs << ", \"min\": " << s.min << ", \"median\": " << s.median
+                      << ", \"p99\": " << s.p99 << ", \"mean\": " << s.mean;
+                for(auto &column : extra_columns(size, s)){
+                    std::string key = column.first;
+                    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+                    m_out << ", \"" << key << "\": " << (column.second.empty() ? "null" : column.second);
                 }
-                cout << "]\n";
-                DATASET << std::endl;
+                m_out << " }";
+            }
+            else{
+                m_out << size << "," << algo << "," << runs << "," << s.min << "," << s.median << "," << s.p99 << "," << s.mean;
+                for(auto &column : extra_columns(size, s)) m_out << "," << column.second;
+                m_out << "\n";
+            }
+            m_first = false;
+        }
+    private:
+        std::ofstream m_out;
+        bool m_json, m_counters, m_counts, m_first;
+
+        /// (name, value) of the optional columns; the value is empty where it was not recorded.
+        std::vector<std::pair<std::string, std::string>> extra_columns(size_type size, const Stats &s) const {
+            auto text = [](double x){ std::ostringstream oss; oss << x; return oss.str(); };
+            std::vector<std::pair<std::string, std::string>> columns;
+            if(m_counters){
+                using sample = sa::perf_sample;
+                const auto &v = s.counters.value;
+                auto ratio = [&](int num, double den){ return v[num] < 0 || den <= 0 ? std::string{} : text(v[num] / den); };
+                for(int c = 0; c < sample::N_COUNTERS; c++)
+                    columns.emplace_back(sample::names()[c], v[c] < 0 ? std::string{} : std::to_string(v[c]));
+                columns.emplace_back("CYCLES_PER_ELEMENT", ratio(sample::CYCLES, size));
+                columns.emplace_back("IPC", v[sample::CYCLES] < 0 ? std::string{} : ratio(sample::INSTRUCTIONS, v[sample::CYCLES]));
+                columns.emplace_back("BRANCH_MISSES_PER_ELEMENT", ratio(sample::BRANCH_MISSES, size));
+                columns.emplace_back("CACHE_MISSES_PER_ELEMENT", ratio(sample::CACHE_MISSES, size));
+            }
+            if(m_counts){
+                const auto &c = s.counts;
+                auto count = [&](std::uint64_t n){ return s.counted ? std::to_string(n) : std::string{}; };
+                auto per_element = [&](std::uint64_t n){ return s.counted && size > 0 ? text(static_cast<double>(n) / size) : std::string{}; };
+                columns.emplace_back("COMPARISONS", count(c.comparisons));
+                columns.emplace_back("SWAPS", count(c.swaps));
+                columns.emplace_back("MOVES", count(c.moves));
+                columns.emplace_back("COPIES", count(c.copies));
+                columns.emplace_back("ALLOCATIONS", count(c.allocations));
+                columns.emplace_back("COMPARISONS_PER_ELEMENT", per_element(c.comparisons));
+                columns.emplace_back("SWAPS_PER_ELEMENT", per_element(c.swaps));
+                columns.emplace_back("MOVES_PER_ELEMENT", per_element(c.moves));
             }
-            DATASET.close();
+            return columns;
+        }
+};
+
+/**
+ * @brief Top-k scenario: gets the k smallest elements of opt.topk_size random values, in order,
+ * by sorting everything with sa::quick, with sa::partial_sort, and with sa::nth_element followed
+ * by sorting the first k; writes the statistics, in milliseconds, to the TOP_K dataset file
+ */
+void topk_scenario(const RunningOpt &opt){
+    std::vector<int> arr_test(opt.topk_size);
+    std::mt19937 gen(opt.seed);
+    for(auto &value : arr_test) value = gen();
+    Dataset DATASET(opt.path + "TOP_K." + opt.format, opt.format == "json");
+
+    for(size_type k = 10; k <= opt.topk_size/10; k *= 10){
+        using It = iterator<int>;
+        auto cmp = compare<int>;
+        std::vector<Algorithm<int>> algos {
+            {"QUICK", false, [cmp](It f, It l){ sa::quick(f, l, cmp); }},
+            {"PARTIAL_SORT", false, [cmp, k](It f, It l){ sa::partial_sort(f, f + k, l, cmp); }},
+            {"NTH_ELEMENT", false, [cmp, k](It f, It l){
+                sa::nth_element(f, f + k, l, cmp);
+                sa::introsort(f, f + k, cmp);
+            }},
+        };
+        cout << " Type:[TOP_K] Size:[" << opt.topk_size << "] K:[" << k << "] Algorithm(ms): ";
+        for(auto &algo : algos){
+            std::vector<double> times;
+            for(int ct_run = 1; ct_run <= opt.n_runs; ct_run++){
+                std::vector<int> copy = arr_test;
+                auto start = std::chrono::steady_clock::now();
+                algo.sort(copy.begin(), copy.end());
+                auto end = std::chrono::steady_clock::now();
+                times.push_back(duration_t(end - start).count());
+                if(!std::is_sorted(copy.begin(), copy.begin() + k, compare<int>)){
+                    std::cerr << "\nERROR: " << algo.name << " did not sort the first " << k << " elements\n";
+                    std::exit(EXIT_FAILURE);
+                }
+            }
+            Stats s = summarize(times);
+            DATASET.write(k, algo.name, opt.n_runs, s);
+            cout << "[" << algo.name << "," << s.median << "]";
+        }
+        cout << "\n";
     }
 }
 
+/**
+ * @brief Runs the selected algorithms over the selected distributions and sizes, on elements of
+ * type T, writing one DATASET file per distribution (suffixed with the type, unless it is int)
+ */
+template< typename T >
+void run_suite(const RunningOpt &opt){
+    std::unique_ptr<sa::perf_counters> perf;
+    if(opt.counters){
+        perf.reset(new sa::perf_counters);
+        if(!perf->available()){
+            std::cerr << "WARNING: hardware counters unavailable (" << perf->error() << "), writing the times only\n";
+            perf.reset();
+        }
+        else if(!perf->error().empty()) std::cerr << "WARNING: some hardware counters unavailable (" << perf->error() << ")\n";
+    }
+    std::vector<Algorithm<T>> algos;
+    for(auto &algo : algorithms<T>(opt)) if(selected(opt.algos, algo.name)) algos.push_back(algo);
+    // the same algorithms on counted elements, for --count; the radix sorts have no counted version.
+    std::vector<Algorithm<sa::counted<T>>> counted_algos;
+    if(opt.count) counted_algos = algorithms<sa::counted<T>>(opt);
+    std::vector<size_type> sizes = opt.sizes();
+    std::string suffix = type_suffix<T>();
 
+    //Loop to each type of vector organization
+    for(auto &dist : distributions()){
+        if(!selected(opt.dists, dist.name)) continue;
+        Dataset DATASET(opt.path + dist.name + suffix + "." + opt.format, opt.format == "json", perf != nullptr, opt.count);
+        for(size_type size : sizes){
+            std::vector<T> arr_test = set_vector<T>(dist, size, opt.seed);
+            std::vector<sa::counted<T>> counted_test;
+            if(opt.count) counted_test = std::vector<sa::counted<T>>(arr_test.begin(), arr_test.end());
+            cout << " Type:["<< dist.name << suffix << "] Size:[" << size << "/" << opt.max_sample_sz << "] Algorithm(ms): ";
+            //Pass by diferents algorithms
+            for(auto &algo : algos){
+                // past the budget, an O(n^2) algorithm would take the whole session.
+                if(algo.quadratic && size > opt.quadratic_max) continue;
+                if(algo.quadratic_on_few_keys && dist.few_keys && size > opt.quadratic_max){
+                    cout << "[" << algo.name << ",skipped]";
+                    continue;
+                }
+                // the counters follow the calling thread only, so they would miss the pool's work.
+                Stats s = time_algorithm(algo, arr_test, opt, algo.parallel ? nullptr : perf.get());
+                for(auto &counted : counted_algos)
+                    if(counted.name == algo.name){
+                        s.counts = count_operations(counted, counted_test);
+                        s.counted = true;
+                    }
+                DATASET.write(size, algo.name, opt.n_runs, s);
+                cout << "[" << algo.name << "," << s.median << "]";
+            }
+            cout << "\n";
+        }
+    }
+}
 
-
+//=== The main function, entry point.
+int main(int argc, char *argv[])
+{
+    RunningOpt opt = parse(argc, argv);
+    if(opt.type == "string") run_suite<std::string>(opt);
+    else if(opt.type == "record") run_suite<Record>(opt);
+    else if(opt.type == "record256") run_suite<Record256>(opt);
+    else{
+        run_suite<int>(opt);
+        if(opt.topk_size > 0) topk_scenario(opt);
+    }
+    return EXIT_SUCCESS;
+}
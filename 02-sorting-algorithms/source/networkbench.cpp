@@ -0,0 +1,68 @@
+/*!
+ * @file networkbench.cpp
+ * Microbenchmark of the sorting networks against insertion sort on small arrays
+ * (8, 16, 32 and 64 ints or floats). Output is CSV with the time per array in nanoseconds.
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+#include "lib/sorting.h"
+
+/// Number of arrays sorted per measurement.
+constexpr std::size_t N_ARRAYS = 20000;
+/// Number of measurements; the fastest one is reported.
+constexpr int N_RUNS = 5;
+
+/**
+ * @brief Sorts N_ARRAYS consecutive arrays of `size` elements with `sort`, N_RUNS times over fresh copies of `data`
+ * @return The best time per array, in nanoseconds
+ */
+template< typename T, typename Sort >
+double time_sort(const std::vector<T> &data, std::size_t size, Sort sort){
+    double best = 0;
+    std::vector<T> work;
+    for(int run = 0; run < N_RUNS; run++) {
+        work = data;
+        auto start = std::chrono::steady_clock::now();
+        for(std::size_t i = 0; i < N_ARRAYS; i++) sort(work.data() + i*size, work.data() + (i+1)*size);
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / N_ARRAYS;
+        if(run == 0 || ns < best) best = ns;
+        for(std::size_t i = 0; i < N_ARRAYS; i++)
+            if(!std::is_sorted(work.begin() + i*size, work.begin() + (i+1)*size)) {
+                std::cerr << "ERROR: array " << i << " of size " << size << " not sorted\n";
+                std::exit(EXIT_FAILURE);
+            }
+    }
+    return best;
+}
+
+/// Prints one line per algorithm for arrays of `size` elements of type T.
+template< typename T >
+void run(const char *type, std::size_t size, std::mt19937 &gen){
+    std::uniform_int_distribution<int> dist(-1000000, 1000000);
+    std::vector<T> data(N_ARRAYS * size);
+    for(auto &value : data) value = static_cast<T>(dist(gen));
+
+    std::cout << type << "," << size << ",insertion,"
+              << time_sort(data, size, [](T *first, T *last){ sa::insertion(first, last, std::less<T>()); }) << "\n";
+    std::cout << type << "," << size << ",network,"
+              << time_sort(data, size, [](T *first, T *last){ sa::network_sort(first, last - first); }) << "\n";
+    std::cout << type << "," << size << ",std::sort,"
+              << time_sort(data, size, [](T *first, T *last){ std::sort(first, last); }) << "\n";
+}
+
+int main(){
+    std::mt19937 gen{2021};
+    std::cout << "TYPE,SIZE,ALGORITHM,NS_PER_ARRAY\n";
+    for(std::size_t size : {8, 16, 32, 64}) {
+        run<std::int32_t>("int", size, gen);
+        run<float>("float", size, gen);
+    }
+}